@@ -1,5 +1,11 @@
+#ifndef DSA_H
+#define DSA_H
 #include <iostream>
+#include <cstdint>
 #include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
 using namespace std;
 
 // this file includes all the data structures that are used everywhere in the project
@@ -263,33 +269,113 @@ public:
     }
 };
 
+// A journal note: when it was written and where its text sits in the list's text slab.
+// Nodes carry no strings of their own; the date is only formatted when it is shown.
 class node
 {
 public:
-    string data;
-    string dateTime; // current date and time
+    int64_t time;    // seconds since the epoch
+    uint32_t offset; // first byte of the text in the slab
+    uint32_t length;
     node *next;
     node *prev;
+};
 
-    node(string value) : data(value), next(NULL), prev(NULL)
+// The bytes of many notes back to back in one growing buffer; text is addressed by offset and length,
+// so a note costs no allocation of its own and notes read in order sit next to each other in memory
+class TextSlab
+{
+public:
+    TextSlab() : dead(0) {}
+
+    // Method to copy text onto the end of the slab and return its offset
+    uint32_t add(const string &text)
     {
-        // Get current date and time
-        time_t now = time(0);
-        tm *ltm = localtime(&now);
-        char buffer[30];
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", ltm);
-        dateTime = buffer;
+        uint32_t offset = bytes.size();
+        bytes.insert(bytes.end(), text.begin(), text.end());
+        return offset;
+    }
+
+    string get(uint32_t offset, uint32_t length) const
+    {
+        return string(bytes.data() + offset, length);
     }
 
-    string getData()
+    // Method to note that length bytes are no longer used by any note
+    void release(uint32_t length)
     {
-        return data;
+        dead += length;
     }
 
-    string getDateTime()
+    // Whether more than half of the slab is text of deleted notes
+    bool wasteful() const
     {
-        return dateTime;
+        return dead > 4096 && dead * 2 > bytes.size();
     }
+
+    // Method to rebuild the slab from the notes still in a list, moving their offsets to the new copy
+    void compact(node *head)
+    {
+        vector<char> kept;
+        kept.reserve(bytes.size() - dead);
+        for (node *current = head; current != NULL; current = current->next)
+        {
+            uint32_t offset = kept.size();
+            kept.insert(kept.end(), bytes.begin() + current->offset, bytes.begin() + current->offset + current->length);
+            current->offset = offset;
+        }
+        bytes.swap(kept);
+        dead = 0;
+    }
+
+private:
+    vector<char> bytes;
+    size_t dead; // bytes belonging to deleted notes
+};
+
+// Hands out nodes from blocks allocated a few hundred at a time, reusing deleted ones, instead of a new per node
+class NodePool
+{
+public:
+    NodePool() : freeList(NULL), used(NODE_POOL_BLOCK) {}
+    ~NodePool()
+    {
+        for (node *block : blocks)
+        {
+            delete[] block;
+        }
+    }
+
+    node *take()
+    {
+        if (freeList != NULL)
+        {
+            node *taken = freeList;
+            freeList = freeList->next;
+            return taken;
+        }
+        if (used == NODE_POOL_BLOCK)
+        {
+            blocks.push_back(new node[NODE_POOL_BLOCK]);
+            used = 0;
+        }
+        return &blocks.back()[used++];
+    }
+
+    void give(node *returned)
+    {
+        returned->next = freeList;
+        freeList = returned;
+    }
+
+private:
+    static const int NODE_POOL_BLOCK = 256;
+    vector<node *> blocks;
+    node *freeList; // deleted nodes, linked through next
+    int used;       // nodes handed out from the last block
+
+    NodePool(const NodePool &);
+    NodePool &operator=(const NodePool &);
 };
 
 class DoublyLinkedList
@@ -301,17 +387,21 @@ public:
 
     DoublyLinkedList() : head(NULL), tail(NULL), s(0) {}
 
-    ~DoublyLinkedList()
+    // The text and the formatted date of a node of this list
+    string getData(const node *n) const
     {
-        node *current = head;
+        return slab.get(n->offset, n->length);
+    }
 
-        while (current != NULL)
-        {
-            node *next = current->next;
-            delete current;
-            current = next;
-        }
+    string getDateTime(const node *n) const
+    {
+        time_t written = (time_t)n->time;
+        tm *ltm = localtime(&written);
+        char buffer[30];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", ltm);
+        return buffer;
     }
+
     // Inside the DoublyLinkedList class
     node *getNodeByIndex(int index)
     {
@@ -335,7 +425,10 @@ public:
     void addNode(const string &data)
     {
         // Adding a new node at the tail
-        node *newNode = new node(data);
+        node *newNode = pool.take();
+        newNode->time = (int64_t)time(0);
+        newNode->offset = slab.add(data);
+        newNode->length = data.size();
         newNode->next = nullptr; // The new node will be the last, so its next is nullptr
         newNode->prev = tail;    // Set the prev pointer to the current tail
 
@@ -359,7 +452,6 @@ public:
     {
         if (head == NULL || j < 1)
         {
-            cout << "Invalid position or linked list is empty!" << endl;
             return false;
         }
 
@@ -409,12 +501,16 @@ public:
         }
         else
         {
-            cout << "Invalid position!" << endl;
             return false;
         }
 
-        cout << "Node at position " << j << " deleted." << endl;
-        delete ptr;
+        slab.release(ptr->length);
+        pool.give(ptr);
+        s--;
+        if (slab.wasteful())
+        {
+            slab.compact(head);
+        }
         return true;
     }
     string displayAll()
@@ -424,59 +520,20 @@ public:
 
         while (current != NULL)
         {
-            result += "Date/Time: " + current->getDateTime() + "\n Note: " + current->getData() + "\n";
+            result += "Date/Time: " + getDateTime(current) + "\n Note: " + getData(current) + "\n";
             current = current->next;
         }
 
         return result;
     }
-    int size()
+    // Nodes in the list; addNode and deleteNode keep the count, so this does not walk the list
+    int size() const
     {
-        node *current = head;
-        int count = 0;
-
-        while (current != NULL)
-        {
-            current = current->next;
-            count++;
-        }
-
-        return count;
+        return s;
     }
 
 private:
-    void sortList()
-    {
-        // Simple bubble sort for demonstration purposes
-        if (!head)
-            return;
-
-        bool swapped;
-        node *ptr1;
-        node *lptr = NULL;
-
-        do
-        {
-            swapped = false;
-            ptr1 = head;
-
-            while (ptr1->next != lptr)
-            {
-                // Compare date and time strings (format YYYY-MM-DD HH:MM:SS)
-                if (ptr1->getDateTime() < ptr1->next->getDateTime())
-                {
-                    swap(ptr1, ptr1->next);
-                    swapped = true;
-                }
-                ptr1 = ptr1->next;
-            }
-            lptr = ptr1;
-        } while (swapped);
-    }
-
-    void swap(node *a, node *b)
-    {
-        std::swap(a->data, b->data);
-        std::swap(a->dateTime, b->dateTime);
-    }
-};
\ No newline at end of file
+    NodePool pool;
+    TextSlab slab;
+};
+#endif
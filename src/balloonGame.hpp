@@ -289,44 +289,16 @@ private:
     }
 
     void displayAffirmation(int x, int y, const char* text) {
-    // Render the given text to create an SDL_Texture
-    SDL_Texture* affirmationTexture = renderText(text);
+    // Draw the text in red from the shared glyph atlas at the specified position
+    SDL_Color textColor = {255, 0, 0, 255};
+    textRenderer.draw(renderer, font, text, x, y, textColor);
 
-    // Check if the rendering was successful
-    if (affirmationTexture != NULL) {
-        // Define the SDL_Rect representing the position and dimensions of the rendered text
-        SDL_Rect textRect = {x, y, 200, 50};
+    // Present the renderer to display the rendered text
+    SDL_RenderPresent(renderer);
 
-        // Copy the rendered text texture onto the renderer at the specified position and dimensions
-        SDL_RenderCopy(renderer, affirmationTexture, NULL, &textRect);
-
-        // Present the renderer to display the rendered text
-        SDL_RenderPresent(renderer);
-
-        // Delay for 1000 milliseconds (1 second) to display the affirmation
-        SDL_Delay(1000);
-
-        // Destroy the rendered text texture to free up memory
-        SDL_DestroyTexture(affirmationTexture);
-    }
+    // Delay for 1000 milliseconds (1 second) to display the affirmation
+    SDL_Delay(1000);
 }
-
-
-    SDL_Texture* renderText(const char* text){
-        SDL_Color textColor = {255, 0, 0, 255};
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, text, textColor);
-        if (textSurface == NULL) {
-            cerr << "TTF_RenderText_Solid Error: " << TTF_GetError() << endl;
-            return NULL;
-        }
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, textSurface);
-        if (texture == NULL) {
-            cerr << "SDL_CreateTextureFromSurface Error: " << SDL_GetError() << endl;
-        }
-
-        SDL_FreeSurface(textSurface);
-        return texture;
-    }
 };
 
 
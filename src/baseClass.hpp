@@ -9,6 +9,7 @@
 #include<string>
 #include <vector>
 #include "DSA.hpp"
+#include "textRenderer.hpp"
 using namespace std;
 class StressReliever{
     protected:
@@ -19,13 +20,16 @@ class StressReliever{
     Mix_Chunk *success;
     SDL_Texture* backgroundTexture;
     TTF_Font* font, *dataFont;
+    TextRenderer textRenderer; // glyph atlases for every font the game draws text with
     int Width, Height;
     const char *gameName;
     public:
-    StressReliever(const char *n = "", int w = 700, int h = 700) : gameName(n), Width(w), Height(h), window(NULL), renderer(NULL), backgroundTexture(NULL), backgroundMusic(NULL), success(NULL), font(NULL), dataFont(NULL) {
+    // vsync should only be asked for by games that present once per batch of events; one that presents per mouse
+    // motion event would wait a display refresh on each of them
+    StressReliever(const char *n = "", int w = 700, int h = 700, bool vsync = false) : gameName(n), Width(w), Height(h), window(NULL), renderer(NULL), backgroundTexture(NULL), backgroundMusic(NULL), success(NULL), font(NULL), dataFont(NULL) {
         SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
         window = SDL_CreateWindow(gameName, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, Width, Height, SDL_WINDOW_SHOWN);
-        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
         IMG_Init(IMG_INIT_PNG); 
         IMG_Init(IMG_INIT_JPG);
         TTF_Init(); 
@@ -33,6 +37,8 @@ class StressReliever{
         Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048);
     }
     ~StressReliever(){
+        // The atlas textures must go before the fonts and renderer they were made from
+        textRenderer.clear();
         TTF_CloseFont(font);
         TTF_CloseFont(dataFont);
         TTF_Quit();
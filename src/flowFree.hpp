@@ -1,240 +1,248 @@
-#include <fstream>
 #include "baseClass.hpp"
+#include "flowGenerator.hpp"
+#include "flowHint.hpp"
+#include "flowLevel.hpp"
+#include "flowPaths.hpp"
+#include "flowRouter.hpp"
+#include "levelPack.hpp"
+#include "flowRenderer.hpp"
+#include "threadPool.hpp"
 const int Width = 800;
 const int Height = 700;
-int GRID_SIZE = 5;
-const int LEVELS = 5;
-const int MAX = 8;
-int CELL_SIZE = 520 / GRID_SIZE;
+const int LEVELS = 5; // hand-made levels in textFiles, used when no level pack is available
+const int MAX_GRID_SIZE = 30;
+const int BOARD_PIXELS = 520; // width and height available to the board on screen
+const int ENDLESS_MAX_SIZE = 16; // generated levels stop growing here so the next one is ready in time
 
-// Structure for RGBA color
-struct ColorRGBA
-{
-    Uint8 r, g, b, a;
-};
-
-// Array of colors for dots
-const ColorRGBA COLORS_ARRAY[] = {
-    {255, 255, 255, 255}, //White
-    {245, 128, 196, 255}, //Color 1
-    {117, 117, 255, 255}, //Color 2
-    {187, 145, 241, 255}, //Color 3
-    {141, 73, 123, 255},  //Color 4
-    {123, 231, 240, 255}, //Color 5
-    {121, 247, 167, 255}, //Color 6
-};
-
-// Class representing the game grid
-class Grid
+class FlowFree : public StressReliever
 {
 public:
-    Grid()
+    FlowFree() : StressReliever("Flow free", 800, 700, true), currentColor(1), level(1), drawingLine(false), imageTexture(NULL), numMoves(0), Margin(20), points(0), nextPuzzleReady(false), levelCount(LEVELS), frameDirty(false), boardTexture(NULL), boardWidth(0), boardHeight(0), boardStale(true), assist(false)
     {
-        reset();
+        initialize();
     }
 
-    // Method to reset the grid
-    void reset()
+    // Method to initialize the game
+    void initialize()
     {
-        for (int row = 0; row < GRID_SIZE; ++row)
+        font = TTF_OpenFont("fonts/Oswald-Bold.ttf", 40);
+        dataFont = TTF_OpenFont("fonts/arial.ttf", 25);
+        backgroundTexture = loadImage("images/FlowFreeBg.jpg");
+        backgroundMusic = Mix_LoadMUS("sound/flowFree-sounds.mp3");
+        success = Mix_LoadWAV("sound/success.mp3");
+        imageTexture = loadImage("images/replay.png");
+        if (!font || !dataFont || !backgroundTexture || !backgroundMusic || !success || !imageTexture)
         {
-            for (int col = 0; col < GRID_SIZE; ++col)
-            {
-                data[row][col] = 0;
-                vis[row][col] = false;
-            }
+            cerr << "Failed to load font, texture or background Music: " << TTF_GetError() << endl;
+            return;
         }
-    }
-
-    // Method to load grid data from a file
-    void loadFromFile(string filename)
-    {
-        ifstream file(filename);
-        if (!file.is_open())
+        srand(time(0));
+        generator.setPool(&generatorPool);
+        // Shipped levels come from the binary pack when it is present, so level switches need no parsing
+        if (pack.open("textFiles/levels.pack"))
         {
-            cerr << "Error opening file: " << filename << endl;
-            return;
+            levelCount = pack.size();
         }
-        for (int row = 0; row < GRID_SIZE; row++)
+    }
+    ~FlowFree()
+    {
+        cleanup();
+    }
+    void run()
+    {
+        level = 1;
+        while (event.type != SDL_QUIT && event.key.keysym.sym != SDLK_ESCAPE)
         {
-            string line;
-            if (getline(file, line))
+            Mix_PlayMusic(backgroundMusic, -1);
+            solution.clear();
+            if (level > levelCount)
+            {
+                // Past the shipped levels: use the level generated in the background while the last one was played
+                generatorPool.wait();
+                if (!nextPuzzleReady)
+                {
+                    break;
+                }
+                currentPuzzle = nextPuzzle;
+                levelModel.load(currentPuzzle.rows, currentPuzzle.cells, currentPuzzle.topology);
+                solution = currentPuzzle.solution;
+            }
+            else if (pack.isOpen())
             {
-                for (int col = 0; col < GRID_SIZE && col < line.size(); col++)
+                PackedLevel packed;
+                if (!pack.level(level - 1, packed) || packed.rows != packed.cols)
+                {
+                    cerr << "Level " << level << " in the level pack is not a square board" << endl;
+                    break;
+                }
+                int cells = packed.rows * packed.cols;
+                levelModel.load(packed.rows, vector<int>(packed.cells, packed.cells + cells), packed.topology);
+                if (packed.solution != NULL)
+                {
+                    solution.assign(packed.solution, packed.solution + cells);
+                }
+                else if (!solveLevel())
                 {
-                    int val = line[col] - '0';
-                    data[row][col] = val;
+                    break;
                 }
             }
+            else
+            {
+                // No pack: the level file is parsed once and solved here
+                if (!levelModel.loadFromFile("textFiles/level" + to_string(level) + ".txt", MAX_GRID_SIZE) || !solveLevel())
+                {
+                    break;
+                }
+            }
+            if (level >= levelCount)
+            {
+                generateNextLevel();
+            }
+            loadLevel();
+            hints.start(levelModel, solution);
+            hintMessage = "";
+            drawGrid();
+            handleEvents();
+            level++;
         }
-        file.close();
     }
 
-    // Method to get the value at a specific grid position
-    int getValue(int row, int col) const
+private:
+    int currentColor;
+    int level;
+    bool drawingLine;
+    SDL_Texture *imageTexture;
+    vector<int> solution; // a full solution of the current level, one color per node, handed to the hint engine
+    int numMoves;
+    int Margin;
+    int points;
+    FlowLevel levelModel; // board shape, fixed dots, endpoint pairs and neighbor tables of the current level
+    FlowGenerator generator;
+    FlowPuzzle currentPuzzle, nextPuzzle;
+    bool nextPuzzleReady;
+    LevelPack pack; // memory-mapped shipped levels with their solutions
+    int levelCount; // levels played before endless mode starts
+    ThreadPool generatorPool; // builds the next endless-mode level, splitting its uniqueness checks across every core; declared after the generator so it stops first
+    DotAtlas dots;
+    bool frameDirty; // set by input handlers; the event loop then composes and presents one frame
+    HintEngine hints;
+    string hintMessage; // status of the last hint, shown under the Hint button
+    FlowPaths paths;    // the player's paths, with undo and a list of changed cells
+    SDL_Texture *boardTexture; // the board cells, kept between frames so only changed cells are redrawn
+    int boardWidth, boardHeight;
+    bool boardStale; // the whole board texture must be redrawn
+    FlowRouter router;
+    bool assist;         // strokes follow the shortest free route to the cursor instead of the straight line
+    vector<int> preview; // route the stroke will take when the mouse is released in assist mode
+
+    // Start the current level over with only its fixed dots on the board
+    void loadLevel()
     {
-        return data[row][col];
+        paths.load(levelModel);
+        router.load(levelModel);
+        preview.clear();
+        boardStale = true;
     }
 
-    // Method to set the value at a specific grid position
-    void setValue(int row, int col, int value)
+    // Solve the level in levelModel, so the hint engine starts out with a solution
+    bool solveLevel()
     {
-        data[row][col] = value;
+        FlowSolver search;
+        if (!search.load(levelModel.getTopology(), levelModel.getCells()) || search.solve() == 0)
+        {
+            cerr << "Level " << level << " has no solution" << endl;
+            return false;
+        }
+        solution = search.solution();
+        return true;
     }
 
-    // Method to check if a move is valid
-    bool valid(int i, int j, int &n)
+    // Start generating the level after this one on the background worker; boards grow by one every two levels
+    // and endless mode alternates between square and torus boards
+    void generateNextLevel()
     {
-        return (i >= 0 && j >= 0 && i <= n - 1 && j <= n - 1 && vis[i][j] == false);
+        int size = min(8 + (level + 1 - levelCount) / 2, ENDLESS_MAX_SIZE);
+        int colors = size * size / 6 + rand() % 3;
+        FlowTopology::Kind shape = (level - levelCount) % 2 == 0 ? FlowTopology::SQUARE : FlowTopology::TORUS;
+        generatorPool.submit([this, size, colors, shape]()
+        {
+            generator.setTopology(shape);
+            nextPuzzleReady = generator.generate(size, size, colors, nextPuzzle);
+        });
     }
 
-    // Method to get the next color to fill
-    pair<int, int> get_color()
+    // Size in pixels of one cell, so boards of every size and shape fill the same area on screen
+    int cellSize()
     {
-        for (int i = 0; i < GRID_SIZE; i++)
+        const FlowTopology &board = levelModel.getTopology();
+        int cell = BOARD_PIXELS / max(board.getRows(), board.getCols());
+        // Shifted hex rows make the board half a cell wider than its columns
+        while (cell > 1 && board.pixelWidth(cell) > BOARD_PIXELS)
         {
-            for (int j = 0; j < GRID_SIZE; j++)
-            {
-                if (data[i][j] != 0 && !vis[i][j])
-                {
-                    return {i, j};
-                }
-            }
+            cell--;
         }
-        return {-1, -1};
+        return cell;
     }
 
-    // Method to solve the puzzle
-    bool solve(int i, int j, int color)
+    // Right edge of the board
+    int boardRight()
     {
-        vis[i][j] = true; // Mark the current cell as visited
-
-        // Explore all possible moves (up, down, left, right)
-        for (int p = 0; p < 4; p++)
-        {
-            int i1 = i + dx[p];
-            int j1 = j + dy[p];
-            
-            // Check if the move is valid
-            if (valid(i1, j1, GRID_SIZE))
-            {
-                // If the adjacent cell has the same color, continue the path
-                if (data[i1][j1] == color)
-                {
-                    vis[i1][j1] = true;                     // Mark the adjacent cell as visited
-                    pair<int, int> nextColor = get_color(); // Find the next color to fill
-                    if (nextColor.first == -1 && nextColor.second == -1)
-                    {
-                        return true; // Base case: No more colors to fill, solution found
-                    }
-                    int c = data[nextColor.first][nextColor.second];
-                    if (solve(nextColor.first, nextColor.second, c))
-                    {
-                        return true; // Recursively continue the path
-                    }
-                    vis[i1][j1] = false; // Backtrack
-                }
-                // If the adjacent cell is empty, try filling it with the current color
-                else if (data[i1][j1] == 0)
-                {
-                    data[i1][j1] = color;
-                    if (solve(i1, j1, color))
-                    {
-                        return true; // Recursively continue the path
-                    }
-                    data[i1][j1] = 0; // Backtrack
-                }
-            }
-        }
-
-        // If no valid move is found, mark the current cell as unvisited and backtrack
-        vis[i][j] = false;
-        return false;
+        return Margin + levelModel.getTopology().pixelWidth(cellSize());
     }
 
-private:
-    int data[MAX][MAX];
-    bool vis[MAX][MAX];
-    int dx[4] = {-1, 0, 0, 1};
-    int dy[4] = {0, -1, 1, 0};
-};
-
-
-
-class FlowFree : public StressReliever
-{
-public:
-    FlowFree() : StressReliever("Flow free", 800, 700), currentColor(1), level(1), Margin(20), selectedDot(-1, -1), drawingLine(false), numMoves(0), points(0)
+    // Top edge of the board, which is centered vertically
+    int boardTop()
     {
-        initialize();
+        return Height / 2 - levelModel.getTopology().pixelHeight(cellSize()) / 2;
     }
 
-    // Method to initialize the game
-    void initialize()
+    // Area of the Reset button in the side panel
+    SDL_Rect resetButton()
     {
-        font = TTF_OpenFont("fonts/Oswald-Bold.ttf", 40);
-        dataFont = TTF_OpenFont("fonts/arial.ttf", 25);
-        backgroundTexture = loadImage("images/FlowFreeBg.jpg");
-        backgroundMusic = Mix_LoadMUS("sound/flowFree-sounds.mp3");
-        success = Mix_LoadWAV("sound/success.mp3");
-        if (!font || !dataFont || !backgroundTexture || !backgroundMusic || !success)
-        {
-            cerr << "Failed to load font, texture or background Music: " << TTF_GetError() << endl;
-            return;
-        }
-        srand(time(0));
+        SDL_Rect button = {boardRight() + 82, 350, 75, 75};
+        return button;
     }
-    ~FlowFree()
+
+    // Area of the Hint button in the side panel, below the reset button
+    SDL_Rect hintButton()
     {
-        cleanup();
+        SDL_Rect button = {boardRight() + 70, 450, 100, 40};
+        return button;
     }
-    void run()
+
+    // Apply a hint from the hint engine to the player's grid
+    void applyHint(const FlowHint &hint)
     {
-        level = 1;
-        GRID_SIZE = 5;
-        while (level <= LEVELS && event.type != SDL_QUIT && event.key.keysym.sym != SDLK_ESCAPE)
+        if (hint.status == FlowHint::PATH)
         {
-            CELL_SIZE = 520 / GRID_SIZE;
-            Mix_PlayMusic(backgroundMusic, -1);
-            string filename = "textFiles/level" + to_string(level) + ".txt";
-            solver.reset();
-            solver.loadFromFile(filename);
-            pair<int, int> p = solver.get_color();
-            int color = solver.getValue(p.first, p.second);
-            bool res = solver.solve(p.first, p.second, color);
-            grid.reset();
-            grid.loadFromFile(filename);
-            drawGrid();
-            handleEvents();
-            level++;
-            if (level >= 3)
-            {
-                GRID_SIZE++;
-            }
+            paths.layPath(hint.color, hint.solution);
+            numMoves++;
+            hintMessage = "";
         }
+        else if (hint.status == FlowHint::CONFLICT)
+        {
+            paths.clearCells(hint.cells);
+            hintMessage = "Cleared a dead end";
+        }
+        else if (hint.status == FlowHint::UNKNOWN)
+        {
+            hintMessage = "No hint found in time";
+        }
+        else
+        {
+            hintMessage = "";
+        }
+        frameDirty = true;
     }
 
-private:
-    int currentColor;
-    int level;
-    pair<int, int> selectedDot;
-    bool drawingLine;
-    SDL_Texture *imageTexture;
-    Grid grid;
-    Grid solver;
-    int numMoves;
-    int Margin;
-    int points;
-    int backendArray[MAX][MAX];
+    // Convert a mouse position into a board cell; FlowTopology::NONE when the position is off the board
+    int cellAt(int x, int y)
+    {
+        return levelModel.getTopology().cellAt(x - Margin, y - boardTop(), cellSize());
+    }
     void drawText(const string text, int x, int y, const SDL_Color color, TTF_Font *f)
     {
-        SDL_Surface *surface = TTF_RenderText_Solid(f, text.c_str(), color);
-        SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-        SDL_Rect textRect = {x, y, surface->w, surface->h};
-        SDL_RenderCopy(renderer, texture, nullptr, &textRect);
-        SDL_DestroyTexture(texture);
-        SDL_FreeSurface(surface);
-        SDL_RenderPresent(renderer);
+        textRenderer.draw(renderer, f, text, x, y, color);
     }
     SDL_Texture *loadImage(string filename)
     {
@@ -256,75 +264,155 @@ private:
     {
         return numMoves * (-0.5) + level * 10;
     }
+    // Compose a whole frame (board, side panel and HUD) and present it once
     void drawGrid()
     {
         drawImage(backgroundTexture, 0, 0, 560, Height);
         // Calculate the vertical center of the window
-        int centerY = Height / 2 - (GRID_SIZE * CELL_SIZE) / 2;
-        // Draw the grid lines on the left side with a vertical offset and a left margin
-        for (int row = 0; row < GRID_SIZE; ++row)
+        const FlowTopology &board = levelModel.getTopology();
+        int cell = cellSize();
+        int centerY = boardTop();
+        int right = boardRight();
+        // Draw the board on the left side with a vertical offset and a left margin
+        renderBoard();
+        SDL_Rect boardRect = {Margin, centerY, boardWidth, boardHeight};
+        SDL_RenderCopy(renderer, boardTexture, NULL, &boardRect);
+        // The assist route is drawn over the board as a thin line of the stroke's color
+        ColorRGBA routeColor = colorFor(currentColor);
+        SDL_SetRenderDrawColor(renderer, routeColor.r, routeColor.g, routeColor.b, 255);
+        for (int step : preview)
         {
-            for (int col = 0; col < GRID_SIZE; ++col)
-            {
-                SDL_Rect cellRect = {Margin + col * CELL_SIZE, centerY + row * CELL_SIZE, CELL_SIZE, CELL_SIZE};
-                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Grid color
-                SDL_RenderDrawRect(renderer, &cellRect);
-                ColorRGBA cellColor;
-                int value = grid.getValue(row, col);
-                if (value >= 1 && value < MAX - 1)
-                {
-                    cellColor = COLORS_ARRAY[value];
-                }
-                else
-                {
-                    cellColor = COLORS_ARRAY[0];
-                }
-                SDL_SetRenderDrawColor(renderer, cellColor.r, cellColor.g, cellColor.b, cellColor.a);
-                int centerX = Margin + col * CELL_SIZE + CELL_SIZE / 2;
-                int cellCenterY = centerY + row * CELL_SIZE + CELL_SIZE / 2;
-                int radius = CELL_SIZE / 3;
-                drawFilledCircle(centerX, cellCenterY, radius, cellColor);
-            }
+            int x, y;
+            board.origin(board.cellOf(step), cell, x, y);
+            SDL_Rect mark = {Margin + x + cell / 3, centerY + y + cell / 3, cell - 2 * (cell / 3), cell - 2 * (cell / 3)};
+            SDL_RenderFillRect(renderer, &mark);
+        }
+        drawImage(backgroundTexture, right + Margin, 0, Width - (right + Margin), Height);
+        // Game details are drawn from the shared glyph atlas, so changing values cost no new textures
+        SDL_Color hudColor = {95, 123, 217, 255};
+        drawText("Level: " + to_string(level), right + 70, 210, hudColor, dataFont);
+        drawText("Moves: " + to_string(numMoves), right + 70, 250, hudColor, dataFont);
+        drawText("Points: " + to_string(points), right + 70, 290, hudColor, dataFont);
+        SDL_Rect resetRect = resetButton();
+        drawImage(imageTexture, resetRect.x, resetRect.y, resetRect.w, resetRect.h);
+        SDL_Rect hintRect = hintButton();
+        SDL_SetRenderDrawColor(renderer, hudColor.r, hudColor.g, hudColor.b, hudColor.a);
+        SDL_RenderDrawRect(renderer, &hintRect);
+        drawText("Hint", hintRect.x + 27, hintRect.y + 6, hudColor, dataFont);
+        if (!hintMessage.empty())
+        {
+            drawText(hintMessage, right + 40, hintRect.y + hintRect.h + 15, hudColor, dataFont);
         }
-        drawImage(backgroundTexture, 2 * Margin + GRID_SIZE * CELL_SIZE, 0, Width - (2 * Margin + GRID_SIZE * CELL_SIZE), Height);
-        SDL_RenderPresent(renderer);
-        // Add your code to render game details here
-        drawText("Level: " + to_string(level), Margin + GRID_SIZE * CELL_SIZE + 70, 210, {95, 123, 217, 255}, dataFont);
-        drawText("Moves: " + to_string(numMoves), Margin + GRID_SIZE * CELL_SIZE + 70, 250, {95, 123, 217, 255}, dataFont);
-        drawText("Points: " + to_string(points), Margin + GRID_SIZE * CELL_SIZE + 70, 290, {95, 123, 217, 255}, dataFont);
         // Present the renderer
-        imageTexture = loadImage("images/replay.png");
-        drawImage(imageTexture, Margin + GRID_SIZE * CELL_SIZE + 82, 350, 75, 75);
         SDL_RenderPresent(renderer);
+        frameDirty = false;
     }
-    void drawFilledCircle(int centerX, int centerY, int radius, ColorRGBA color)
+
+    // Bring the board texture up to date: all cells after a level change, otherwise only the cells the paths changed
+    void renderBoard()
     {
-        for (int y = -radius; y <= radius; ++y)
+        const FlowTopology &board = levelModel.getTopology();
+        int width = board.pixelWidth(cellSize());
+        int height = board.pixelHeight(cellSize());
+        dots.prepare(renderer, cellSize(), levelModel.getColors());
+        if (boardTexture == NULL || boardWidth != width || boardHeight != height)
         {
-            for (int x = -radius; x <= radius; ++x)
+            if (boardTexture != NULL)
             {
-                if (x * x + y * y <= radius * radius)
-                {
-                    SDL_RenderDrawPoint(renderer, centerX + x, centerY + y);
-                }
+                SDL_DestroyTexture(boardTexture);
             }
+            boardTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET, width, height);
+            SDL_SetTextureBlendMode(boardTexture, SDL_BLENDMODE_BLEND);
+            boardWidth = width;
+            boardHeight = height;
+            boardStale = true;
+        }
+        SDL_SetRenderTarget(renderer, boardTexture);
+        if (boardStale)
+        {
+            // Clear the strip hex boards leave free at the row ends
+            SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+            SDL_RenderClear(renderer);
+            for (int cell = 0; cell < board.cells(); cell++)
+            {
+                drawCell(cell);
+            }
+            boardStale = false;
+        }
+        else
+        {
+            for (int node : paths.dirtyCells())
+            {
+                drawCell(board.cellOf(node));
+            }
+        }
+        paths.clearDirty();
+        SDL_SetRenderTarget(renderer, NULL);
+    }
+
+    // Draw one cell into the board texture
+    void drawCell(int cell)
+    {
+        const FlowTopology &board = levelModel.getTopology();
+        int pixels = cellSize();
+        int x, y;
+        board.origin(cell, pixels, x, y);
+        SDL_Rect cellRect = {x, y, pixels, pixels};
+        // Wipe the cell to transparent so the window background shows through it
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+        SDL_RenderFillRect(renderer, &cellRect);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Grid color
+        SDL_RenderDrawRect(renderer, &cellRect);
+        int value = paths.colorAt(cell);
+        int crossing = board.crossing(cell);
+        if (crossing != FlowTopology::NONE)
+        {
+            // A bridge shows the path crossing it sideways as a band across the cell and the other one as a band down it
+            int band = pixels / 3;
+            SDL_Rect across = {x, y + band, pixels, pixels - 2 * band};
+            SDL_Rect down = {x + band, y, pixels - 2 * band, pixels};
+            drawBand(across, value);
+            drawBand(down, paths.colorAt(crossing));
+            return;
         }
+        // Endpoints and empty cells are circles; cells filled by the player are path blocks
+        DotAtlas::Sprite sprite = (value == 0 || levelModel.isFixed(cell)) ? DotAtlas::DOT : DotAtlas::PATH;
+        dots.draw(renderer, sprite, value, cellRect.x, cellRect.y);
+    }
+
+    // Draw one lane of a bridge: filled with the color of the path on it, or outlined while it is free
+    void drawBand(const SDL_Rect &band, int color)
+    {
+        if (color == 0)
+        {
+            SDL_SetRenderDrawColor(renderer, 128, 128, 128, 255);
+            SDL_RenderDrawRect(renderer, &band);
+            return;
+        }
+        ColorRGBA fill = colorFor(color);
+        SDL_SetRenderDrawColor(renderer, fill.r, fill.g, fill.b, 255);
+        SDL_RenderFillRect(renderer, &band);
     }
 
 // Handle various SDL events during the game
 void handleEvents()
 {
-    // Find and load fixed dots from the level text file
-    findFixedDots();
-
     // Flag indicating whether the current level is completed
     bool levelComplete = false;
 
     // Continue handling events until the level is completed
     while (!levelComplete)
     {
-        // Process all pending SDL events
-        while (SDL_PollEvent(&event))
+        // Sleep until input arrives instead of spinning; the timeout only keeps the loop responsive
+        if (!SDL_WaitEventTimeout(&event, 100))
+        {
+            continue;
+        }
+
+        // Process the event that woke us up and then all other pending SDL events
+        do
         {
             // Check the type of each SDL event
             if (event.type == SDL_KEYDOWN)
@@ -334,6 +422,18 @@ void handleEvents()
                 {
                     return;
                 }
+                // Ctrl+Z or Backspace takes back the last stroke
+                if (!drawingLine && (event.key.keysym.sym == SDLK_BACKSPACE || (event.key.keysym.sym == SDLK_z && (event.key.keysym.mod & KMOD_CTRL))))
+                {
+                    paths.undo();
+                }
+                // A switches the routing assist on and off
+                if (!drawingLine && event.key.keysym.sym == SDLK_a)
+                {
+                    assist = !assist;
+                    hintMessage = assist ? "Assist on" : "Assist off";
+                    frameDirty = true;
+                }
             }
             else if (event.type == SDL_QUIT)
             {
@@ -348,22 +448,51 @@ void handleEvents()
             else if (event.type == SDL_MOUSEBUTTONUP)
             {
                 // Handle mouse button up event
-                handleMouseUp(event.button.x, event.button.y);
+                handleMouseUp();
             }
             else if (event.type == SDL_MOUSEMOTION)
             {
                 // Handle mouse motion event (user dragging the mouse)
                 handleMouseMotion(event.motion.x, event.motion.y);
             }
+            else if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET)
+            {
+                // The driver dropped the contents of target textures, or with a device reset every texture;
+                // lost textures are made again and the board is redrawn whole
+                if (event.type == SDL_RENDER_DEVICE_RESET)
+                {
+                    resetBoardTextures();
+                }
+                boardStale = true;
+                frameDirty = true;
+            }
+        } while (SDL_PollEvent(&event));
+
+        // Cells the paths changed are redrawn with the next frame
+        if (!paths.dirtyCells().empty())
+        {
+            frameDirty = true;
         }
 
-        // Check if the current grid matches the solution grid, indicating level completion
-        levelComplete = compareGrids(grid, solver);
+        // A finished hint wakes the loop with a user event; apply it before drawing
+        FlowHint hint;
+        if (hints.poll(hint))
+        {
+            applyHint(hint);
+        }
+
+        // Draw once for the whole batch of events instead of once per event
+        if (frameDirty)
+        {
+            drawGrid();
+        }
+
+        // The paths keep a running count of covered nodes, so this check is O(1) until the board is full
+        levelComplete = paths.isSolved();
     }
 
-    // Reset drawing state and selected dot after completing the level
+    // Reset drawing state after completing the level
     drawingLine = false;
-    selectedDot = make_pair(-1, -1);
 
     // Reset the number of moves
     numMoves = 0;
@@ -377,9 +506,10 @@ void handleEvents()
         // Display the level completion message
         string levelCompletionMessage = "Level " + to_string(level) + " Completed!";
         drawText(levelCompletionMessage, Width / 4, 250, {95, 123, 217, 255}, font);
+        SDL_RenderPresent(renderer);
 
-        // If the current level is less than 5, delay for 2000 milliseconds and clear the renderer for the next level
-        if (level < 5)
+        // Unless the last shipped level was just completed, delay for 2000 milliseconds and clear the renderer for the next level
+        if (level != levelCount)
         {
             SDL_Delay(2000);
             SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
@@ -387,10 +517,11 @@ void handleEvents()
         }
         else
         {
-            // If the current level is 5 or greater, the game is won
+            // Completing the last shipped level wins the game; play then continues with generated levels
             string gameWonMessage = "Game Won!";
             // Display the "Game Won!" message
             drawText(gameWonMessage, 210, 320, {95, 123, 217, 255}, font);
+            SDL_RenderPresent(renderer);
             // Delay for 3000 milliseconds before returning from the game loop
             SDL_Delay(3000);
             return;
@@ -402,44 +533,48 @@ void handleEvents()
   // Handle mouse button down event
 void handleMouseDown(int x, int y)
 {
-    // Calculate the vertical center of the grid
-    int centerY = Height / 2 - (GRID_SIZE * CELL_SIZE) / 2;
-
     // Check if the mouse click is within the "Reset" button area
-    if (x >= 630 && x <= 685 && y >= 350 && y <= 405)
+    SDL_Rect resetRect = resetButton();
+    if (x >= resetRect.x && x < resetRect.x + resetRect.w && y >= resetRect.y && y < resetRect.y + resetRect.h)
     {
-        // Generate the filename for the current level's text file
-        string filename = "textFiles/level" + to_string(level) + ".txt";
-
-        // Reset the grid by loading data from the level text file
-        grid.reset();
-        grid.loadFromFile(filename);
+        // Reset the grid to the starting dots of the current level
+        loadLevel();
 
         // Redraw the grid to reflect the changes
-        drawGrid();
+        frameDirty = true;
 
         // Exit the function to avoid processing additional actions for this click
         return;
     }
 
-    // Calculate the row and column corresponding to the mouse click within the grid
-    int row = (y - centerY) / CELL_SIZE;
-    int col = (x - Margin) / CELL_SIZE;
-
-    // Retrieve the value of the dot at the clicked position
-    int dotValue = grid.getValue(row, col);
+    // Check if the mouse click is on the "Hint" button
+    SDL_Rect hintRect = hintButton();
+    if (x >= hintRect.x && x < hintRect.x + hintRect.w && y >= hintRect.y && y < hintRect.y + hintRect.h)
+    {
+        // The hint is worked out on a worker thread and applied when it arrives
+        if (hints.request(paths.board()))
+        {
+            hintMessage = "Thinking...";
+            frameDirty = true;
+        }
+        return;
+    }
 
-    // Check if the clicked position contains a valid dot (dotValue > 0)
-    if (dotValue > 0)
+    // Find the board cell under the mouse click
+    int cell = cellAt(x, y);
+    if (cell == FlowTopology::NONE)
     {
-        // Store the coordinates of the selected dot
-        selectedDot = std::make_pair(row, col);
+        return;
+    }
 
+    // Start a stroke from an endpoint, or from any cell of an existing path, which cuts that path back to the cell
+    if (paths.begin(cell))
+    {
         // Set the drawingLine flag to indicate that the user is drawing a line
         drawingLine = true;
 
-        // Store the color of the selected dot for line drawing
-        currentColor = dotValue;
+        // Store the color being drawn
+        currentColor = paths.activeColor();
     }
 
     // Increment the number of moves made by the user
@@ -448,32 +583,20 @@ void handleMouseDown(int x, int y)
 
 
 // Handle mouse button up event
-void handleMouseUp(int x, int y)
+void handleMouseUp()
 {
     // Check if the user is currently drawing a line
     if (drawingLine)
     {
-        // Calculate the vertical center of the grid
-        int centerY = Height / 2 - (GRID_SIZE * CELL_SIZE) / 2;
-
-        // Calculate the row and column corresponding to the mouse release position within the grid
-        int row = (y - centerY) / CELL_SIZE;
-        int col = (x - Margin) / CELL_SIZE;
-
-        // Check if the released position contains a dot of the same color
-        if (grid.getValue(row, col) == currentColor)
+        // The whole stroke becomes one undo step
+        if (!preview.empty())
         {
-            // Connect dots and draw the line
-            grid.setValue(selectedDot.first, selectedDot.second, currentColor);
-            grid.setValue(row, col, currentColor);
-
-            // Redraw the grid to reflect the changes
-            drawGrid();
+            paths.follow(preview);
+            preview.clear();
+            frameDirty = true;
         }
-
-        // Reset drawing-related flags and variables
+        paths.end();
         drawingLine = false;
-        selectedDot = make_pair(-1, -1);
 
         // Update the user's points based on the completed line
         points += calculateScore();
@@ -485,107 +608,36 @@ void handleMouseUp(int x, int y)
     {
         if (drawingLine)
         {
-            // Draw the grid to clear previous lines
-            drawGrid();
-            int centerY = Height / 2 - (GRID_SIZE * CELL_SIZE) / 2;
-            int row = (y - centerY) / CELL_SIZE;
-            int col = (x - Margin) / CELL_SIZE;
-            // Calculate the absolute differences between the current and selected coordinates
-            int rowDiff = abs(row - selectedDot.first);
-            int colDiff = abs(col - selectedDot.second);
-            // Check if the movement is predominantly horizontal or vertical
-            if (rowDiff > colDiff)
+            int cell = cellAt(x, y);
+            if (cell == FlowTopology::NONE)
             {
-                // Update the grid vertically
-                int startRow = min(selectedDot.first, row);
-                int endRow = max(selectedDot.first, row);
-                for (int r = startRow; r <= endRow; ++r)
-                {
-                    int c = selectedDot.second;
-                    // Check if the current cell is an initial dot and a fixed point
-                    if (!(grid.getValue(r, c) == currentColor && isFixedDot(r, c)) && !isFixedDot(r, c))
-                    {
-                        grid.setValue(r, c, currentColor);
-                    }
-                }
+                return;
             }
-            else
+            if (assist && !paths.onPath(currentColor, cell))
             {
-                // Update the grid horizontally
-                int startCol = min(selectedDot.second, col);
-                int endCol = max(selectedDot.second, col);
-                for (int c = startCol; c <= endCol; ++c)
-                {
-                    int r = selectedDot.first;
-                    // Check if the current cell is an initial dot and a fixed point
-                    if (!(grid.getValue(r, c) == currentColor && isFixedDot(r, c)) && !isFixedDot(r, c))
-                    {
-                        grid.setValue(r, c, currentColor);
-                    }
-                }
-            }
-            // Present the renderer
-            SDL_RenderPresent(renderer);
-        }
-    }
-    void cleanup()
-    {
-        SDL_DestroyTexture(imageTexture);
-    }
-    bool compareGrids(Grid &userGrid, Grid &solutionGrid)
-    {
-        for (int row = 0; row < GRID_SIZE; ++row)
-        {
-            for (int col = 0; col < GRID_SIZE; ++col)
-            {
-                if (userGrid.getValue(row, col) < 0 || userGrid.getValue(row, col) > MAX || userGrid.getValue(row, col) != solutionGrid.getValue(row, col))
-                {
-                    return false;
-                }
+                // Preview the shortest route around the other paths; it is laid down when the mouse is released
+                router.route(paths, cell, preview);
+                frameDirty = true;
+                return;
             }
+            // Extend, retract or reroute the path towards the cell under the mouse; crossed paths are cut
+            preview.clear();
+            paths.dragTo(cell);
         }
-        return true;
     }
-    
-    void findFixedDots()
+    // Method to drop the board texture and the dot atlas, so the next renderBoard makes both again
+    void resetBoardTextures()
     {
-        string filename = "textFiles/level" + to_string(level) + ".txt";
-        ifstream file(filename);
-        for (int row = 0; row < GRID_SIZE; ++row)
+        if (boardTexture != NULL)
         {
-            string line;
-            if (getline(file, line))
-            {
-                for (int col = 0; col < GRID_SIZE && col < line.size(); ++col)
-                {
-                    int val = line[col] - '0';
-                    backendArray[row][col] = val;
-                }
-            }
+            SDL_DestroyTexture(boardTexture);
+            boardTexture = NULL;
         }
-        file.close();
+        dots.free();
     }
-
-    bool isFixedDot(int row, int col)
+    void cleanup()
     {
-        vector<pair<int, int>> fixedPoints;
-        for (int r = 0; r < GRID_SIZE; ++r)
-        {
-            for (int c = 0; c < GRID_SIZE; ++c)
-            {
-                if (backendArray[r][c] != 0)
-                {
-                    fixedPoints.push_back({r, c});
-                }
-            }
-        }
-        for (const auto &point : fixedPoints)
-        {
-            if (row == point.first && col == point.second)
-            {
-                return true;
-            }
-        }
-        return false;
+        SDL_DestroyTexture(imageTexture);
+        resetBoardTextures();
     }
 };
\ No newline at end of file
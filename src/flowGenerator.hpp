@@ -0,0 +1,336 @@
+#ifndef FLOW_GENERATOR_H
+#define FLOW_GENERATOR_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string>
+#include "parallelSolver.hpp"
+
+const int PARALLEL_MIN_CELLS = 144; // smaller boards are checked faster than their search can be split up
+
+// A generated level: the endpoints the player sees plus the unique full solution
+struct FlowPuzzle
+{
+    int rows, cols, colors;
+    int difficulty; // 1 (trivial) to 10 (hard), from the work the solver needed
+    FlowTopology::Kind topology;
+    vector<int> cells;    // row-major, 0 for empty and 1..colors for endpoints
+    vector<int> solution; // row-major, every cell colored
+    FlowPuzzle() : rows(0), cols(0), colors(0), difficulty(0), topology(FlowTopology::SQUARE) {}
+};
+
+// Builds random levels by laying a random Hamiltonian path over the board and cutting it into one segment per color,
+// which gives a set of paths that fills every cell. Every step follows the board's neighbor table, so square and
+// torus boards are generated the same way. Hex boards are not: a random path on them turns back on itself so
+// often that almost no candidate is unique, so hex levels are made by hand.
+// Each candidate is handed to FlowSolver and only kept if it has exactly one solution.
+class FlowGenerator
+{
+public:
+    FlowGenerator(unsigned seed = random_device()()) : rng(seed), nodeLimit(200000), pool(NULL), shape(FlowTopology::SQUARE) {}
+
+    // Method to cap the solver work spent on each candidate; candidates that need more are rejected
+    void setNodeLimit(long long limit)
+    {
+        nodeLimit = limit;
+    }
+
+    // Method to run the uniqueness checks of large boards on a thread pool; NULL checks on the calling thread
+    void setPool(ThreadPool *workers)
+    {
+        pool = workers;
+    }
+
+    // Method to pick the board shape of the levels generated from now on
+    void setTopology(FlowTopology::Kind kind)
+    {
+        shape = kind;
+    }
+
+    // Method to generate a uniquely solvable level, trying at most `attempts` candidates
+    bool generate(int rows, int cols, int colors, FlowPuzzle &out, int attempts = 500)
+    {
+        int cells = rows * cols;
+        if (colors < 1 || cells < 3 * colors)
+        {
+            cerr << "Cannot fit " << colors << " colors on a " << rows << "x" << cols << " board" << endl;
+            return false;
+        }
+        if (shape == FlowTopology::HEX)
+        {
+            cerr << "Hex levels cannot be generated" << endl;
+            return false;
+        }
+        if (!board.build(shape, rows, cols))
+        {
+            return false;
+        }
+        vector<int> path, starts, solution;
+        for (int attempt = 0; attempt < attempts; attempt++)
+        {
+            randomPath(path);
+            if (!cutPath(colors, path, starts))
+            {
+                continue;
+            }
+            solution.assign(cells, 0);
+            vector<int> puzzle(cells, 0);
+            for (int color = 1; color <= colors; color++)
+            {
+                int start = starts[color - 1];
+                int end = color < colors ? starts[color] : cells;
+                for (int i = start; i < end; i++)
+                {
+                    solution[path[i]] = color;
+                }
+                puzzle[path[start]] = color;
+                puzzle[path[end - 1]] = color;
+            }
+            SolverStats stats;
+            if (!isUnique(puzzle, stats))
+            {
+                continue;
+            }
+            out.rows = rows;
+            out.cols = cols;
+            out.colors = colors;
+            out.topology = shape;
+            out.cells = puzzle;
+            out.solution = solution;
+            out.difficulty = rateDifficulty(stats, cells);
+            return true;
+        }
+        return false;
+    }
+
+    // Method to turn solver effort into a 1..10 rating: log2 of the backtracks per cell, shifted by board size
+    static int rateDifficulty(const SolverStats &stats, int cells)
+    {
+        int rating = 1;
+        long long work = stats.backtracks / max(1, cells / 8);
+        while (work > 1 && rating < 8)
+        {
+            work /= 2;
+            rating++;
+        }
+        if (cells >= 100)
+        {
+            rating++;
+        }
+        if (cells >= 225)
+        {
+            rating++;
+        }
+        return min(rating, 10);
+    }
+
+private:
+    mt19937 rng;
+    long long nodeLimit;
+    ThreadPool *pool;
+    FlowTopology::Kind shape;
+    FlowTopology board; // neighbor table of the board being generated
+
+    // Method to check that a candidate has exactly one solution within the node budget
+    bool isUnique(const vector<int> &puzzle, SolverStats &stats)
+    {
+        // With a single worker the split search only adds task overhead to the same sequential work
+        if (pool != NULL && pool->size() > 1 && board.cells() >= PARALLEL_MIN_CELLS)
+        {
+            ParallelSolver solver(*pool);
+            solver.load(board, puzzle);
+            bool unique = solver.solve(2, nodeLimit) == 1 && !solver.exhausted();
+            stats = solver.getStats();
+            return unique;
+        }
+        FlowSolver solver;
+        solver.load(board, puzzle);
+        bool unique = solver.solve(2, nodeLimit) == 1 && !solver.exhausted();
+        stats = solver.getStats();
+        return unique;
+    }
+
+    int randomInt(int low, int high)
+    {
+        return uniform_int_distribution<int>(low, high)(rng);
+    }
+
+    // Method to build a random Hamiltonian path: start from a serpentine and apply many backbite moves.
+    // Consecutive rows are neighbors at both ends in every topology, so the serpentine is always a valid start.
+    void randomPath(vector<int> &path)
+    {
+        int rows = board.getRows();
+        int cols = board.getCols();
+        int cells = rows * cols;
+        path.resize(cells);
+        vector<int> position(cells);
+        for (int row = 0; row < rows; row++)
+        {
+            for (int col = 0; col < cols; col++)
+            {
+                int i = row * cols + col;
+                int cell = row * cols + (row % 2 == 0 ? col : cols - 1 - col);
+                path[i] = cell;
+                position[cell] = i;
+            }
+        }
+        for (int move = 0; move < cells * 10; move++)
+        {
+            if (randomInt(0, 1) == 0)
+            {
+                reverse(path.begin(), path.end());
+                for (int i = 0; i < cells; i++)
+                {
+                    position[path[i]] = i;
+                }
+            }
+            // Backbite: link the tail to one of its neighbors and reverse the loop that forms
+            int tail = path[cells - 1];
+            int next = board.neighbors(tail)[randomInt(0, board.degree() - 1)];
+            if (next == FlowTopology::NONE)
+            {
+                continue;
+            }
+            int i = position[next];
+            if (i >= cells - 2)
+            {
+                continue;
+            }
+            reverse(path.begin() + i + 1, path.end());
+            for (int j = i + 1; j < cells; j++)
+            {
+                position[path[j]] = j;
+            }
+        }
+    }
+
+    // Method to cut the path into `colors` segments of at least 3 cells.
+    // A segment is forced to end wherever it would run alongside itself, since such paths make the puzzle ambiguous,
+    // and long segments are then split at random until there is one per color.
+    bool cutPath(int colors, const vector<int> &path, vector<int> &starts)
+    {
+        int cells = board.cells();
+        vector<int> segment(cells, -1);
+        starts.assign(1, 0);
+        for (int i = 0; i < cells; i++)
+        {
+            int cell = path[i];
+            int current = starts.size() - 1;
+            bool touches = false;
+            const int *next = board.neighbors(cell);
+            for (int p = 0; p < board.degree(); p++)
+            {
+                touches = touches || (next[p] != FlowTopology::NONE && segment[next[p]] == current && next[p] != path[i - 1]);
+            }
+            if (touches)
+            {
+                if (i - starts.back() < 3)
+                {
+                    return false;
+                }
+                starts.push_back(i);
+                current++;
+            }
+            segment[cell] = current;
+        }
+        if (cells - starts.back() < 3 || (int)starts.size() > colors)
+        {
+            return false;
+        }
+        while ((int)starts.size() < colors)
+        {
+            vector<int> splittable;
+            for (int s = 0; s < (int)starts.size(); s++)
+            {
+                int end = s + 1 < (int)starts.size() ? starts[s + 1] : cells;
+                if (end - starts[s] >= 6)
+                {
+                    splittable.push_back(s);
+                }
+            }
+            if (splittable.empty())
+            {
+                return false;
+            }
+            int s = splittable[randomInt(0, splittable.size() - 1)];
+            int end = s + 1 < (int)starts.size() ? starts[s + 1] : cells;
+            starts.insert(starts.begin() + s + 1, randomInt(starts[s] + 3, end - 3));
+        }
+        return true;
+    }
+};
+
+// Level packs are plain text: a "level rows cols colors difficulty" line, the puzzle rows, then the solution rows.
+// Cells are written as space separated numbers so packs are not limited to nine colors.
+// Text packs only hold square boards; other topologies need a binary pack.
+
+// Function to write a set of generated levels to a level pack file
+inline bool saveLevelPack(const string &filename, const vector<FlowPuzzle> &levels)
+{
+    ofstream file(filename);
+    if (!file.is_open())
+    {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+    for (const FlowPuzzle &level : levels)
+    {
+        if (level.topology != FlowTopology::SQUARE)
+        {
+            cerr << "Text level packs only hold square boards: " << filename << endl;
+            return false;
+        }
+        file << "level " << level.rows << " " << level.cols << " " << level.colors << " " << level.difficulty << "\n";
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const vector<int> &source = pass == 0 ? level.cells : level.solution;
+            for (int row = 0; row < level.rows; row++)
+            {
+                for (int col = 0; col < level.cols; col++)
+                {
+                    file << source[row * level.cols + col] << (col + 1 < level.cols ? " " : "\n");
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Function to read every level from a level pack file
+inline bool loadLevelPack(const string &filename, vector<FlowPuzzle> &levels)
+{
+    ifstream file(filename);
+    if (!file.is_open())
+    {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+    string tag;
+    FlowPuzzle level;
+    while (file >> tag >> level.rows >> level.cols >> level.colors >> level.difficulty)
+    {
+        if (tag != "level" || level.rows <= 0 || level.cols <= 0)
+        {
+            cerr << "Malformed level pack: " << filename << endl;
+            return false;
+        }
+        level.cells.assign(level.rows * level.cols, 0);
+        level.solution.assign(level.rows * level.cols, 0);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            vector<int> &target = pass == 0 ? level.cells : level.solution;
+            for (int i = 0; i < level.rows * level.cols; i++)
+            {
+                if (!(file >> target[i]) || target[i] < 0 || target[i] > level.colors)
+                {
+                    cerr << "Malformed level pack: " << filename << endl;
+                    return false;
+                }
+            }
+        }
+        levels.push_back(level);
+    }
+    return true;
+}
+#endif
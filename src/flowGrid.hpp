@@ -0,0 +1,188 @@
+#ifndef FLOW_GRID_H
+#define FLOW_GRID_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+#include "flowSolver.hpp"
+using namespace std;
+
+// Class representing the original square game grid and its backtracking solver.
+// The game itself now runs on FlowLevel, FlowPaths and FlowSolver; Grid stays as the baseline of the solver benchmark.
+// Cells live in one flat byte array, row-major, with a one cell WALL border around the board,
+// so moving to a neighbor is a single offset and never needs a bounds test.
+class Grid
+{
+public:
+    enum { WALL = 255 };
+
+    Grid(int n = 5) : nodeLimit(-1), aborted(false), depth(0)
+    {
+        resize(n);
+    }
+
+    // Method to change the board size; this clears the grid
+    void resize(int n)
+    {
+        size = n;
+        stride = n + 2;
+        data.assign(stride * stride, WALL);
+        vis.assign(stride * stride, false);
+        offsets[0] = -stride; // up
+        offsets[1] = -1;      // left
+        offsets[2] = 1;       // right
+        offsets[3] = stride;  // down
+        reset();
+    }
+
+    // Method to reset the grid
+    void reset()
+    {
+        for (int row = 0; row < size; ++row)
+        {
+            for (int col = 0; col < size; ++col)
+            {
+                data[index(row, col)] = 0;
+                vis[index(row, col)] = false;
+            }
+        }
+    }
+
+    // Method to load grid data from row-major cell values, such as a generated level
+    void loadFromCells(int n, const vector<int> &cells)
+    {
+        resize(n);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                data[index(row, col)] = cells[row * size + col];
+            }
+        }
+    }
+
+    // Method to get the value at a specific grid position
+    int getValue(int row, int col) const
+    {
+        return data[index(row, col)];
+    }
+
+    // Method to get the next color to fill
+    pair<int, int> get_color()
+    {
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = 0; j < size; j++)
+            {
+                int cell = index(i, j);
+                if (data[cell] != 0 && !vis[cell])
+                {
+                    return {i, j};
+                }
+            }
+        }
+        return {-1, -1};
+    }
+
+    // Method to solve the puzzle, giving up after nodeLimit cells have been tried (-1 for no limit)
+    bool solve(int i, int j, int color, long long limit = -1)
+    {
+        stats = SolverStats();
+        nodeLimit = limit;
+        aborted = false;
+        depth = 0;
+        return solveFrom(index(i, j), color);
+    }
+
+    // True when the last solve() stopped because it ran out of its node budget
+    bool exhausted() const
+    {
+        return aborted;
+    }
+
+    // Work counters of the last solve(), for benchmarking against FlowSolver
+    const SolverStats &getStats() const
+    {
+        return stats;
+    }
+
+private:
+    int size;   // cells per row and column
+    int stride; // size plus the two border cells
+    vector<Uint8> data;
+    vector<bool> vis;
+    int offsets[4];     // neighbor steps: up, left, right, down
+    SolverStats stats;
+    long long nodeLimit;
+    bool aborted;
+    int depth; // current recursion depth of solveFrom
+
+    int index(int row, int col) const
+    {
+        return (row + 1) * stride + col + 1;
+    }
+
+    // Method to check if a move is valid; the WALL border stops moves off the board
+    bool valid(int cell) const
+    {
+        return data[cell] != WALL && vis[cell] == false;
+    }
+
+    bool solveFrom(int cell, int color)
+    {
+        stats.nodes++;
+        if (nodeLimit >= 0 && stats.nodes > nodeLimit)
+        {
+            aborted = true;
+            return false;
+        }
+        depth++;
+        stats.maxDepth = max(stats.maxDepth, depth);
+        vis[cell] = true; // Mark the current cell as visited
+
+        // Explore all possible moves (up, left, right, down)
+        for (int p = 0; p < 4; p++)
+        {
+            int next = cell + offsets[p];
+
+            // Check if the move is valid
+            if (valid(next))
+            {
+                // If the adjacent cell has the same color, continue the path
+                if (data[next] == color)
+                {
+                    vis[next] = true;                       // Mark the adjacent cell as visited
+                    pair<int, int> nextColor = get_color(); // Find the next color to fill
+                    if (nextColor.first == -1 && nextColor.second == -1)
+                    {
+                        return true; // Base case: No more colors to fill, solution found
+                    }
+                    int c = getValue(nextColor.first, nextColor.second);
+                    if (solveFrom(index(nextColor.first, nextColor.second), c))
+                    {
+                        return true; // Recursively continue the path
+                    }
+                    vis[next] = false; // Backtrack
+                    stats.backtracks++;
+                }
+                // If the adjacent cell is empty, try filling it with the current color
+                else if (data[next] == 0)
+                {
+                    data[next] = color;
+                    if (solveFrom(next, color))
+                    {
+                        return true; // Recursively continue the path
+                    }
+                    data[next] = 0; // Backtrack
+                    stats.backtracks++;
+                }
+            }
+        }
+
+        // If no valid move is found, mark the current cell as unvisited and backtrack
+        vis[cell] = false;
+        depth--;
+        return false;
+    }
+};
+#endif
@@ -0,0 +1,171 @@
+#ifndef FLOW_HINT_H
+#define FLOW_HINT_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include "flowLevel.hpp"
+#include "flowSolver.hpp"
+#include "threadPool.hpp"
+
+// Result of a hint request
+struct FlowHint
+{
+    enum Status
+    {
+        PATH,     // cells holds the full path of one color to draw
+        CONFLICT, // the drawing cannot be completed; cells holds the drawn cells to clear
+        UNKNOWN,  // the search ran out of time
+        COMPLETE  // the board already matches a solution
+    };
+    Status status;
+    int color;
+    vector<int> cells;    // nodes of the level's topology; the first ones are the row-major cells
+    vector<int> solution; // full solution the hint was taken from, one value per node; empty unless status is PATH
+    FlowHint() : status(UNKNOWN), color(0) {}
+};
+
+// Works out hints on a worker thread so the game loop never waits for the solver.
+// The player's drawn cells become constraints for FlowSolver. The last solution found is kept, and as long as
+// the drawing still agrees with it the next hint is read straight from it without searching again.
+class HintEngine
+{
+public:
+    HintEngine(double budgetMs = 50) : budget(budgetMs), nodes(0), ready(false), worker(1)
+    {
+        lock = SDL_CreateMutex();
+    }
+    ~HintEngine()
+    {
+        worker.wait();
+        SDL_DestroyMutex(lock);
+    }
+
+    // Method to prepare for a new level; solution is a known full solution, or empty if there is none yet
+    void start(const FlowLevel &level, const vector<int> &solution)
+    {
+        worker.wait(); // a hint for the previous level may still be running
+        nodes = level.getNodes();
+        startCells = level.getCells();
+        cached = solution;
+        solver.load(level.getTopology(), startCells);
+        SDL_LockMutex(lock);
+        ready = false;
+        SDL_UnlockMutex(lock);
+    }
+
+    // Method to ask for a hint on the player's board (the color of every node); false while another hint is being worked out
+    bool request(const vector<int> &board)
+    {
+        if (!worker.idle())
+        {
+            return false;
+        }
+        worker.submit([this, board]()
+        {
+            FlowHint hint = compute(board);
+            SDL_LockMutex(lock);
+            result = hint;
+            ready = true;
+            SDL_UnlockMutex(lock);
+            // Wake the game loop, which sleeps until the next event arrives
+            SDL_Event wake;
+            SDL_zero(wake);
+            wake.type = SDL_USEREVENT;
+            SDL_PushEvent(&wake);
+        });
+        return true;
+    }
+
+    // Method to collect a finished hint without blocking
+    bool poll(FlowHint &out)
+    {
+        SDL_LockMutex(lock);
+        bool found = ready;
+        if (ready)
+        {
+            out = result;
+            ready = false;
+        }
+        SDL_UnlockMutex(lock);
+        return found;
+    }
+
+private:
+    double budget; // milliseconds one hint may search for
+    int nodes;
+    vector<int> startCells;
+    vector<int> cached; // last solution known to fit the player's drawing
+    FlowSolver solver;  // loaded once per level, so its buffers are reused by every hint
+    SDL_mutex *lock;
+    FlowHint result;
+    bool ready;
+    ThreadPool worker; // declared last so its thread stops before the members it uses are destroyed
+
+    // Runs on the worker thread
+    FlowHint compute(const vector<int> &board)
+    {
+        FlowHint hint;
+        vector<int> drawn(nodes, 0);
+        bool fits = !cached.empty();
+        for (int i = 0; i < nodes; i++)
+        {
+            if (startCells[i] == 0 && board[i] != 0)
+            {
+                drawn[i] = board[i];
+                fits = fits && cached[i] == board[i];
+            }
+        }
+        if (!fits)
+        {
+            solver.constrain(drawn);
+            if (solver.solve(1, -1, budget) == 0)
+            {
+                if (solver.exhausted())
+                {
+                    return hint;
+                }
+                // No solution keeps every drawn cell: report the ones that disagree with the last known solution
+                hint.status = FlowHint::CONFLICT;
+                for (int i = 0; i < nodes; i++)
+                {
+                    if (drawn[i] != 0 && (cached.empty() || cached[i] != drawn[i]))
+                    {
+                        hint.cells.push_back(i);
+                    }
+                }
+                return hint;
+            }
+            cached = solver.solution();
+        }
+        // Reveal the unfinished color the player has got furthest with
+        vector<int> total(solver.getColors() + 1, 0), correct(solver.getColors() + 1, 0);
+        for (int i = 0; i < nodes; i++)
+        {
+            total[cached[i]]++;
+            correct[cached[i]] += board[i] == cached[i];
+        }
+        int best = 0;
+        for (int color = 1; color < (int)total.size(); color++)
+        {
+            if (correct[color] < total[color] && (best == 0 || correct[color] * total[best] > correct[best] * total[color]))
+            {
+                best = color;
+            }
+        }
+        if (best == 0)
+        {
+            hint.status = FlowHint::COMPLETE;
+            return hint;
+        }
+        hint.status = FlowHint::PATH;
+        hint.color = best;
+        hint.solution = cached;
+        for (int i = 0; i < nodes; i++)
+        {
+            if (cached[i] == best)
+            {
+                hint.cells.push_back(i);
+            }
+        }
+        return hint;
+    }
+};
+#endif
@@ -0,0 +1,189 @@
+#ifndef FLOW_LEVEL_H
+#define FLOW_LEVEL_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "flowTopology.hpp"
+using namespace std;
+
+// Read-only description of a level, built once when the level is loaded.
+// Input handling, the solver and the renderer all query it instead of rescanning the board,
+// so every lookup on the hot path is O(1) and never allocates.
+// Cells are numbered row-major without a border: cell = row * size + col. Paths run through the nodes of the
+// level's FlowTopology, which are the cells themselves plus one extra node per bridge.
+class FlowLevel
+{
+public:
+    enum { NONE = -1 };
+
+    FlowLevel() : size(0), colors(0) {}
+
+    // Method to read a level file: one line of digits per row, 0 for empty, 1..9 for the endpoints of a color and
+    // + for a bridge. The board size is the number of digit-led lines, capped at maxSize.
+    // An optional "topology hex" or "topology torus" line picks the board shape; the default is square.
+    bool loadFromFile(const string &filename, int maxSize)
+    {
+        ifstream file(filename);
+        if (!file.is_open())
+        {
+            cerr << "Error opening file: " << filename << endl;
+            return false;
+        }
+        vector<string> lines;
+        string line;
+        FlowTopology::Kind kind = FlowTopology::SQUARE;
+        while (getline(file, line) && (int)lines.size() < maxSize)
+        {
+            if (!line.empty() && ((line[0] >= '0' && line[0] <= '9') || line[0] == '+'))
+            {
+                lines.push_back(line);
+            }
+            else if (line.compare(0, 9, "topology ") == 0 && !FlowTopology::parse(line.substr(9), kind))
+            {
+                cerr << "Unknown topology in " << filename << ": " << line.substr(9) << endl;
+                return false;
+            }
+        }
+        file.close();
+        int n = lines.size();
+        vector<int> values(n * n, 0), bridges;
+        for (int row = 0; row < n; row++)
+        {
+            for (int col = 0; col < n && col < (int)lines[row].size(); col++)
+            {
+                int val = lines[row][col] - '0';
+                if (val >= 0 && val <= 9)
+                {
+                    values[row * n + col] = val;
+                }
+                else if (lines[row][col] == '+')
+                {
+                    bridges.push_back(row * n + col);
+                }
+            }
+        }
+        return load(n, values, kind, bridges);
+    }
+
+    // Method to build the model from row-major cell values, such as a generated level, on a board of the given shape
+    bool load(int n, const vector<int> &values, FlowTopology::Kind kind = FlowTopology::SQUARE, const vector<int> &bridges = vector<int>())
+    {
+        if (!topology.build(kind, n, n, bridges))
+        {
+            return false;
+        }
+        size = n;
+        cells = values;
+        cells.resize(topology.nodes(), 0); // the second nodes of bridges start empty
+        colors = 0;
+        for (int value : cells)
+        {
+            colors = max(colors, value);
+        }
+        for (int cell : bridges)
+        {
+            if (cells[cell] != 0)
+            {
+                cerr << "Bridge cell " << cell << " cannot hold an endpoint" << endl;
+                return false;
+            }
+        }
+        fixedBits.assign((topology.nodes() + 63) / 64, 0);
+        ends.assign((colors + 1) * 2, NONE);
+        for (int cell = 0; cell < size * size; cell++)
+        {
+            int value = cells[cell];
+            if (value == 0)
+            {
+                continue;
+            }
+            fixedBits[cell >> 6] |= (uint64_t)1 << (cell & 63);
+            int slot = ends[value * 2] == NONE ? value * 2 : value * 2 + 1;
+            if (ends[slot] != NONE)
+            {
+                cerr << "Color " << value << " has more than two endpoints" << endl;
+                return false;
+            }
+            ends[slot] = cell;
+        }
+        return true;
+    }
+
+    int getSize() const
+    {
+        return size;
+    }
+
+    // Highest color number on the board
+    int getColors() const
+    {
+        return colors;
+    }
+
+    // Board shape and neighbor tables
+    const FlowTopology &getTopology() const
+    {
+        return topology;
+    }
+
+    // Cells plus the second nodes of bridges
+    int getNodes() const
+    {
+        return topology.nodes();
+    }
+
+    // Starting value of every node: 0 for empty, the color number for endpoints; the first size * size are the cells
+    const vector<int> &getCells() const
+    {
+        return cells;
+    }
+
+    // Method to check whether a cell holds one of the level's fixed endpoints
+    bool isFixed(int row, int col) const
+    {
+        return isFixed(row * size + col);
+    }
+    bool isFixed(int cell) const
+    {
+        return (fixedBits[cell >> 6] >> (cell & 63)) & 1;
+    }
+
+    // First (which = 0) or second (which = 1) endpoint of a color, or NONE
+    int endpoint(int color, int which) const
+    {
+        return color > 0 && color <= colors ? ends[color * 2 + which] : NONE;
+    }
+
+    // The other endpoint of the color whose endpoint is at cell, or NONE when cell is not an endpoint
+    int partner(int cell) const
+    {
+        if (!isFixed(cell))
+        {
+            return NONE;
+        }
+        int color = cells[cell];
+        return ends[color * 2] == cell ? ends[color * 2 + 1] : ends[color * 2];
+    }
+
+    // The neighbors of a node, degree() of them, NONE where the board ends
+    const int *neighbors(int node) const
+    {
+        return topology.neighbors(node);
+    }
+    int degree() const
+    {
+        return topology.degree();
+    }
+
+private:
+    int size;
+    int colors;
+    vector<int> cells;
+    vector<uint64_t> fixedBits; // one bit per cell, set for endpoints
+    vector<int> ends;           // two endpoint cells per color, indexed color * 2 + which
+    FlowTopology topology;
+};
+#endif
@@ -0,0 +1,415 @@
+#ifndef FLOW_PATHS_H
+#define FLOW_PATHS_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cstdlib>
+#include <deque>
+#include "flowLevel.hpp"
+
+// The paths the player has drawn, one deque of nodes per color, starting at the endpoint the path was drawn from.
+// Paths only ever grow or shrink at their head, so every change is O(1) per node and the undo log only has to
+// remember which node was added to or removed from which color.
+// Changed nodes are collected in a dirty list so the board can redraw just those cells.
+// Nodes are the cells of the level plus the second node of each bridge (see FlowTopology); the stroke methods
+// begin() and dragTo() take the cell under the mouse and work out the node themselves.
+class FlowPaths
+{
+public:
+    FlowPaths() : level(NULL), active(0), changes(0), filled(0) {}
+
+    // Method to start with empty paths for a level
+    void load(const FlowLevel &model)
+    {
+        level = &model;
+        int cells = level->getNodes();
+        paths.assign(level->getColors() + 1, deque<int>());
+        owner.assign(cells, 0);
+        position.assign(cells, 0);
+        dirtyFlag.assign(cells, false);
+        dirty.clear();
+        history.clear();
+        moves.clear();
+        active = 0;
+        filled = 0;
+    }
+
+    // Method to remove every path; this cannot be undone
+    void reset()
+    {
+        for (int color = 1; color < (int)paths.size(); color++)
+        {
+            while (!paths[color].empty())
+            {
+                pop(color);
+            }
+        }
+        history.clear();
+        moves.clear();
+        active = 0;
+    }
+
+    // Color of a node: the path running through it, or the endpoint color for fixed nodes
+    int colorAt(int cell) const
+    {
+        return owner[cell] != 0 ? owner[cell] : level->getCells()[cell];
+    }
+
+    // Color of the stroke being drawn, 0 between strokes
+    int activeColor() const
+    {
+        return active;
+    }
+
+    // True when the color's path runs through a node of cell
+    bool onPath(int color, int cell) const
+    {
+        int crossing = level->getTopology().crossing(cell);
+        return owner[cell] == color || (crossing != FlowLevel::NONE && owner[crossing] == color);
+    }
+
+    // First and last cell of a color's path; the path must not be empty
+    int front(int color) const
+    {
+        return paths[color].front();
+    }
+    int head(int color) const
+    {
+        return paths[color].back();
+    }
+
+    // Counter that changes whenever any cell changes color, so callers can tell when results they keep are stale
+    unsigned long long version() const
+    {
+        return changes;
+    }
+
+    // True when the color's path runs from one endpoint to the other
+    bool isComplete(int color) const
+    {
+        return paths[color].size() > 1 && level->isFixed(paths[color].back());
+    }
+
+    // True when every node is covered and every path is complete, which is what solving a level means.
+    // The covered nodes are counted as paths change, so this is O(1) until the board is full.
+    bool isSolved() const
+    {
+        if (filled < (int)owner.size())
+        {
+            return false;
+        }
+        for (int color = 1; color < (int)paths.size(); color++)
+        {
+            if (!isComplete(color))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Method to copy out the color of every node, as the solver and hint engine take boards
+    vector<int> board() const
+    {
+        vector<int> values(owner.size());
+        for (int node = 0; node < (int)owner.size(); node++)
+        {
+            values[node] = colorAt(node);
+        }
+        return values;
+    }
+
+    // Method to start a stroke at a cell: an endpoint starts its path afresh, a path cell cuts its path back to there.
+    // Returns false when there is nothing to draw from the cell.
+    bool begin(int cell)
+    {
+        active = 0;
+        if (level->isFixed(cell))
+        {
+            int color = level->getCells()[cell];
+            moves.push_back(history.size());
+            // Starting from the endpoint a path began at keeps just that endpoint; starting from the other one starts over
+            truncate(color, owner[cell] == color && paths[color].front() == cell ? 0 : -1);
+            if (paths[color].empty())
+            {
+                push(color, cell);
+            }
+            active = color;
+            return true;
+        }
+        // On a bridge crossed by two paths the horizontal one is picked up
+        int crossing = level->getTopology().crossing(cell);
+        int node = owner[cell] == 0 && crossing != FlowLevel::NONE ? crossing : cell;
+        if (owner[node] != 0)
+        {
+            moves.push_back(history.size());
+            active = owner[node];
+            truncate(active, position[node]);
+            return true;
+        }
+        return false;
+    }
+
+    // Method to continue the stroke towards a cell, one neighboring step at a time, stopping at the first blocked step
+    void dragTo(int target)
+    {
+        if (active == 0)
+        {
+            return;
+        }
+        const FlowTopology &board = level->getTopology();
+        int crossing = board.crossing(target);
+        int node = crossing != FlowLevel::NONE && owner[crossing] == active ? crossing : target;
+        if (owner[node] == active)
+        {
+            truncate(active, position[node]);
+            return;
+        }
+        while (board.cellOf(paths[active].back()) != target)
+        {
+            // Step onto the target if it is a neighbor, otherwise onto the neighbor closest to it
+            int head = paths[active].back();
+            const int *next = level->neighbors(head);
+            int step = FlowLevel::NONE;
+            int best = board.distance(board.cellOf(head), target);
+            for (int p = 0; p < level->degree(); p++)
+            {
+                if (next[p] == FlowLevel::NONE)
+                {
+                    continue;
+                }
+                int cell = board.cellOf(next[p]);
+                if (cell == target)
+                {
+                    step = next[p];
+                    break;
+                }
+                if (board.distance(cell, target) < best)
+                {
+                    best = board.distance(cell, target);
+                    step = next[p];
+                }
+            }
+            if (step == FlowLevel::NONE || !extend(step))
+            {
+                return;
+            }
+        }
+    }
+
+    // Method to continue the stroke along a route of neighboring cells, stopping at the first blocked step
+    void follow(const vector<int> &route)
+    {
+        for (int cell : route)
+        {
+            if (active == 0 || !extend(cell))
+            {
+                return;
+            }
+        }
+    }
+
+    // Method to finish the stroke; everything it changed becomes one undo step
+    void end()
+    {
+        if (active != 0 && moves.back() == history.size())
+        {
+            moves.pop_back(); // the stroke changed nothing
+        }
+        active = 0;
+    }
+
+    // Method to revert the last stroke; false when there is nothing to undo
+    bool undo()
+    {
+        if (moves.empty())
+        {
+            return false;
+        }
+        size_t start = moves.back();
+        moves.pop_back();
+        while (history.size() > start)
+        {
+            Step step = history.back();
+            history.pop_back();
+            if (step.added)
+            {
+                paths[step.color].pop_back();
+                setOwner(step.cell, 0, 0);
+            }
+            else
+            {
+                paths[step.color].push_back(step.cell);
+                setOwner(step.cell, step.color, paths[step.color].size() - 1);
+            }
+        }
+        active = 0;
+        return true;
+    }
+
+    // Method to lay down a color's whole path from a full solution (one value per node), cutting any path in its way, as one undo step
+    void layPath(int color, const vector<int> &solution)
+    {
+        vector<int> order;
+        vector<bool> used(solution.size(), false);
+        int start = level->endpoint(color, 0);
+        used[start] = true;
+        order.push_back(start);
+        int cells = 0;
+        for (int value : solution)
+        {
+            cells += value == color;
+        }
+        if (!walk(color, solution, cells, used, order))
+        {
+            return;
+        }
+        moves.push_back(history.size());
+        truncate(color, -1);
+        for (int cell : order)
+        {
+            if (owner[cell] != 0 && owner[cell] != color)
+            {
+                truncate(owner[cell], position[cell] - 1);
+            }
+            push(color, cell);
+        }
+    }
+
+    // Method to cut every path back to just before the given nodes, as one undo step
+    void clearCells(const vector<int> &cells)
+    {
+        moves.push_back(history.size());
+        for (int cell : cells)
+        {
+            if (owner[cell] != 0)
+            {
+                truncate(owner[cell], position[cell] - 1);
+            }
+        }
+        if (moves.back() == history.size())
+        {
+            moves.pop_back();
+        }
+    }
+
+    // Nodes whose color changed since clearDirty()
+    const vector<int> &dirtyCells() const
+    {
+        return dirty;
+    }
+
+    void clearDirty()
+    {
+        for (int cell : dirty)
+        {
+            dirtyFlag[cell] = false;
+        }
+        dirty.clear();
+    }
+
+private:
+    // One cell added to or removed from the head of a path
+    struct Step
+    {
+        int color;
+        int cell;
+        bool added;
+    };
+    const FlowLevel *level;
+    vector<deque<int>> paths; // indexed by color
+    vector<int> owner;        // color of the path through each node, 0 for none
+    vector<int> position;     // index of each node in its path
+    vector<bool> dirtyFlag;
+    vector<int> dirty;
+    vector<Step> history;
+    vector<size_t> moves; // index in history where each stroke starts
+    int active;           // color being drawn, 0 between strokes
+    unsigned long long changes;
+    int filled; // nodes some path runs through
+
+    void setOwner(int cell, int color, int index)
+    {
+        filled += (color != 0) - (owner[cell] != 0);
+        owner[cell] = color;
+        position[cell] = index;
+        changes++;
+        if (!dirtyFlag[cell])
+        {
+            dirtyFlag[cell] = true;
+            dirty.push_back(cell);
+        }
+    }
+
+    void push(int color, int cell)
+    {
+        paths[color].push_back(cell);
+        setOwner(cell, color, paths[color].size() - 1);
+        history.push_back({color, cell, true});
+    }
+
+    void pop(int color)
+    {
+        int cell = paths[color].back();
+        paths[color].pop_back();
+        setOwner(cell, 0, 0);
+        history.push_back({color, cell, false});
+    }
+
+    // Method to shorten a path so that its last cell is at index keep (-1 empties it)
+    void truncate(int color, int keep)
+    {
+        while ((int)paths[color].size() > keep + 1)
+        {
+            pop(color);
+        }
+    }
+
+    // Method to add one node next to the head of the active path
+    bool extend(int cell)
+    {
+        deque<int> &path = paths[active];
+        if (path.size() > 1 && path[path.size() - 2] == cell)
+        {
+            pop(active); // moving back over the path retracts it
+            return true;
+        }
+        if (isComplete(active) || (level->isFixed(cell) && level->getCells()[cell] != active))
+        {
+            return false;
+        }
+        if (owner[cell] != 0)
+        {
+            // Crossing another path cuts it where it is crossed
+            truncate(owner[cell], position[cell] - 1);
+        }
+        push(active, cell);
+        return true;
+    }
+
+    // Method to order a color's solution nodes into a path from its first endpoint, using every node of that color
+    bool walk(int color, const vector<int> &solution, int cells, vector<bool> &used, vector<int> &order)
+    {
+        int head = order.back();
+        if ((int)order.size() == cells)
+        {
+            return head == level->endpoint(color, 1);
+        }
+        const int *next = level->neighbors(head);
+        for (int p = 0; p < level->degree(); p++)
+        {
+            int cell = next[p];
+            if (cell != FlowLevel::NONE && !used[cell] && solution[cell] == color)
+            {
+                used[cell] = true;
+                order.push_back(cell);
+                if (walk(color, solution, cells, used, order))
+                {
+                    return true;
+                }
+                order.pop_back();
+                used[cell] = false;
+            }
+        }
+        return false;
+    }
+};
+#endif
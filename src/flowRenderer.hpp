@@ -0,0 +1,166 @@
+#ifndef FLOW_RENDERER_H
+#define FLOW_RENDERER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Structure for RGBA color
+struct ColorRGBA
+{
+    Uint8 r, g, b, a;
+};
+
+// Array of colors for dots
+const ColorRGBA COLORS_ARRAY[] = {
+    {255, 255, 255, 255}, //White
+    {245, 128, 196, 255}, //Color 1
+    {117, 117, 255, 255}, //Color 2
+    {187, 145, 241, 255}, //Color 3
+    {141, 73, 123, 255},  //Color 4
+    {123, 231, 240, 255}, //Color 5
+    {121, 247, 167, 255}, //Color 6
+    {255, 179, 102, 255}, //Color 7
+    {250, 231, 110, 255}, //Color 8
+    {255, 110, 110, 255}, //Color 9
+    {92, 186, 126, 255},  //Color 10
+    {64, 149, 190, 255},  //Color 11
+    {206, 164, 122, 255}, //Color 12
+    {171, 196, 82, 255},  //Color 13
+    {160, 160, 160, 255}, //Color 14
+};
+const int COLOR_COUNT = sizeof(COLORS_ARRAY) / sizeof(COLORS_ARRAY[0]);
+
+// Function to get the color of a dot; colors past the table are spread around the hue circle
+inline ColorRGBA colorFor(int value)
+{
+    if (value < COLOR_COUNT)
+    {
+        return COLORS_ARRAY[value];
+    }
+    // Golden angle steps keep neighbouring color numbers far apart
+    float hue = fmod(value * 137.508f, 360.0f) / 60.0f;
+    float x = 1.0f - fabs(fmod(hue, 2.0f) - 1.0f);
+    float sectors[6][3] = {{1, x, 0}, {x, 1, 0}, {0, 1, x}, {0, x, 1}, {x, 0, 1}, {1, 0, x}};
+    float *rgb = sectors[(int)hue % 6];
+    return {(Uint8)(80 + rgb[0] * 175), (Uint8)(80 + rgb[1] * 175), (Uint8)(80 + rgb[2] * 175), 255};
+}
+
+// One texture holding an antialiased sprite of every kind in every color for the current cell size.
+// Drawing a cell is then a single SDL_RenderCopy instead of one SDL_RenderDrawPoint per pixel.
+class DotAtlas
+{
+public:
+    enum Sprite
+    {
+        DOT,  // endpoint and empty-cell circle
+        PATH, // rounded block filling a cell on a path
+        SPRITES
+    };
+
+    DotAtlas() : texture(NULL), cell(0), colors(0), columns(0) {}
+    ~DotAtlas()
+    {
+        free();
+    }
+
+    // Method to rebuild the atlas; does nothing unless the cell size or number of colors changed
+    bool prepare(SDL_Renderer *renderer, int cellSize, int colorCount)
+    {
+        if (texture != NULL && cellSize == cell && colorCount <= colors)
+        {
+            return true;
+        }
+        free();
+        cell = cellSize;
+        colors = max(colorCount, COLOR_COUNT - 1);
+        int sprites = (colors + 1) * SPRITES;
+        columns = max(1, min(sprites, 2048 / cell));
+        int rows = (sprites + columns - 1) / columns;
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, columns * cell, rows * cell, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!surface)
+        {
+            cerr << "Failed to create dot atlas: " << SDL_GetError() << endl;
+            return false;
+        }
+        SDL_LockSurface(surface);
+        Uint8 *pixels = (Uint8 *)surface->pixels;
+        memset(pixels, 0, surface->pitch * surface->h);
+        for (int color = 0; color <= colors; color++)
+        {
+            for (int sprite = 0; sprite < SPRITES; sprite++)
+            {
+                SDL_Rect slot = slotFor((Sprite)sprite, color);
+                rasterize(pixels + slot.y * surface->pitch + slot.x * 4, surface->pitch, (Sprite)sprite, colorFor(color));
+            }
+        }
+        SDL_UnlockSurface(surface);
+        texture = SDL_CreateTextureFromSurface(renderer, surface);
+        SDL_FreeSurface(surface);
+        if (!texture)
+        {
+            cerr << "Failed to upload dot atlas: " << SDL_GetError() << endl;
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return true;
+    }
+
+    // Method to draw a sprite into the cell whose top-left corner is (x, y)
+    void draw(SDL_Renderer *renderer, Sprite sprite, int color, int x, int y)
+    {
+        SDL_Rect source = slotFor(sprite, min(color, colors));
+        SDL_Rect target = {x, y, cell, cell};
+        SDL_RenderCopy(renderer, texture, &source, &target);
+    }
+
+    void free()
+    {
+        if (texture != NULL)
+        {
+            SDL_DestroyTexture(texture);
+            texture = NULL;
+        }
+    }
+
+private:
+    SDL_Texture *texture;
+    int cell;    // sprite width and height in pixels
+    int colors;  // highest color number in the atlas
+    int columns; // sprites per atlas row
+
+    SDL_Rect slotFor(Sprite sprite, int color) const
+    {
+        int i = color * SPRITES + sprite;
+        return {(i % columns) * cell, (i / columns) * cell, cell, cell};
+    }
+
+    // Method to fill one sprite; coverage comes from the signed distance to the shape edge, which gives smooth edges
+    void rasterize(Uint8 *origin, int pitch, Sprite sprite, ColorRGBA color)
+    {
+        float center = cell / 2.0f;
+        float radius = sprite == DOT ? cell / 3.0f : cell / 4.0f;
+        float half = sprite == DOT ? 0.0f : cell * 0.38f - radius; // straight part of the rounded block
+        for (int y = 0; y < cell; y++)
+        {
+            Uint8 *row = origin + y * pitch;
+            for (int x = 0; x < cell; x++)
+            {
+                float dx = max(fabs(x + 0.5f - center) - half, 0.0f);
+                float dy = max(fabs(y + 0.5f - center) - half, 0.0f);
+                float coverage = radius + 0.5f - sqrt(dx * dx + dy * dy);
+                coverage = coverage < 0 ? 0 : (coverage > 1 ? 1 : coverage);
+                row[x * 4 + 0] = color.r;
+                row[x * 4 + 1] = color.g;
+                row[x * 4 + 2] = color.b;
+                row[x * 4 + 3] = (Uint8)(color.a * coverage);
+            }
+        }
+    }
+};
+#endif
@@ -0,0 +1,123 @@
+#ifndef FLOW_ROUTER_H
+#define FLOW_ROUTER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <vector>
+#include "flowLevel.hpp"
+#include "flowPaths.hpp"
+
+// Finds the shortest route for the path being drawn from its head to a cell, going around every occupied cell.
+// Every step costs the same, so a breadth-first search from the head gives shortest routes; unlike A* its search
+// tree does not depend on the goal, so it is kept between queries and only grown further when a cursor cell has
+// not been reached yet. It is thrown away only when the head or any path changes.
+// All buffers are sized once per level; a query never allocates.
+class FlowRouter
+{
+public:
+    FlowRouter() : level(NULL), generation(0), start(FlowLevel::NONE), color(0), version(0), target(FlowLevel::NONE), queueHead(0), queueTail(0) {}
+
+    // Method to size the search buffers for a level
+    void load(const FlowLevel &model)
+    {
+        level = &model;
+        int cells = level->getNodes();
+        seen.assign(cells, 0);
+        parent.assign(cells, FlowLevel::NONE);
+        frontier.assign(cells, 0);
+        generation = 0;
+        start = FlowLevel::NONE;
+    }
+
+    // Method to route the active path of paths to the cell goal. route receives the nodes to add after the head,
+    // in order, ending in goal; false when no free route exists.
+    bool route(const FlowPaths &paths, int goal, vector<int> &route)
+    {
+        route.clear();
+        int active = paths.activeColor();
+        if (active == 0 || paths.isComplete(active))
+        {
+            return false;
+        }
+        int head = paths.head(active);
+        if (head != start || active != color || paths.version() != version)
+        {
+            restart(paths, active, head);
+        }
+        // A bridge cell can be reached through either of its nodes
+        int crossing = level->getTopology().crossing(goal);
+        if (crossing == FlowLevel::NONE)
+        {
+            crossing = goal;
+        }
+        if (paths.colorAt(goal) != 0 && paths.colorAt(crossing) != 0 && goal != target)
+        {
+            return false;
+        }
+        // Grow the search tree only as far as the goal
+        while (seen[goal] != generation && seen[crossing] != generation && queueHead < queueTail)
+        {
+            expand(paths, frontier[queueHead++]);
+        }
+        int end = seen[goal] == generation ? goal : crossing;
+        if (seen[end] != generation || end == start)
+        {
+            return false;
+        }
+        for (int cell = end; cell != start; cell = parent[cell])
+        {
+            route.push_back(cell);
+        }
+        reverse(route.begin(), route.end());
+        return true;
+    }
+
+private:
+    const FlowLevel *level;
+    vector<unsigned> seen; // cells reached by the current search hold the current generation
+    vector<int> parent;    // cell each reached cell was reached from
+    vector<int> frontier;  // breadth-first queue; every cell enters it at most once
+    unsigned generation;
+    int start;             // head the current search tree grows from
+    int color;
+    unsigned long long version; // paths version the tree was built against
+    int target;            // free endpoint of the color being routed
+    int queueHead, queueTail;
+
+    // Method to start a fresh search tree from a head; bumping the generation forgets the old tree in O(1)
+    void restart(const FlowPaths &paths, int active, int head)
+    {
+        if (++generation == 0)
+        {
+            fill(seen.begin(), seen.end(), 0);
+            generation = 1;
+        }
+        start = head;
+        color = active;
+        version = paths.version();
+        target = level->partner(paths.front(active));
+        queueHead = queueTail = 0;
+        seen[head] = generation;
+        frontier[queueTail++] = head;
+    }
+
+    void expand(const FlowPaths &paths, int cell)
+    {
+        // The route has to end at the endpoint, so nothing is reached through it
+        if (cell == target)
+        {
+            return;
+        }
+        const int *next = level->neighbors(cell);
+        for (int p = 0; p < level->degree(); p++)
+        {
+            int n = next[p];
+            if (n != FlowLevel::NONE && seen[n] != generation && (paths.colorAt(n) == 0 || n == target))
+            {
+                seen[n] = generation;
+                parent[n] = cell;
+                frontier[queueTail++] = n;
+            }
+        }
+    }
+};
+#endif
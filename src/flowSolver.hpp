@@ -0,0 +1,492 @@
+#ifndef FLOW_SOLVER_H
+#define FLOW_SOLVER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include "flowTopology.hpp"
+using namespace std;
+
+// Counters collected while searching, used for difficulty rating and benchmarking
+struct SolverStats
+{
+    long long nodes;      // board states expanded
+    long long backtracks; // moves undone after a failed branch
+    int maxDepth;         // deepest recursion reached
+    SolverStats() : nodes(0), backtracks(0), maxDepth(0) {}
+};
+
+// Backtracking solver for FlowFree puzzles of any size.
+// Unlike Grid::solve it requires every cell to be covered, so it can count solutions and prove a puzzle unique.
+// The board is one value per node of a FlowTopology, so any board shape runs through the same search.
+// The solver keeps its own copy of the neighbor table in which off-board neighbors point at a single extra WALL
+// node, so neighbor lookups never need bounds checks.
+class FlowSolver
+{
+public:
+    enum { WALL = -1 };
+
+    FlowSolver() : nodes(0), degree(4), wall(0), colors(0), empty(0), found(0), maxSolutions(1), nodeLimit(-1), timeLimit(-1), aborted(false), depth(0), splitDepth(-1), splitTasks(NULL), cancel(NULL), sharedNodes(NULL), sharedFound(NULL) {}
+
+    // Method to load a puzzle from row-major cells: 0 for empty and 1..n for the two endpoints of each color
+    bool load(int r, int c, const vector<int> &cells)
+    {
+        FlowTopology square;
+        return square.build(FlowTopology::SQUARE, r, c) && load(square, cells);
+    }
+
+    // Method to load a puzzle on any board shape; cells holds one value per node of the topology
+    bool load(const FlowTopology &topology, const vector<int> &cells)
+    {
+        nodes = topology.nodes();
+        degree = topology.degree();
+        wall = nodes;
+        if ((int)cells.size() < nodes)
+        {
+            cerr << "Puzzle has " << cells.size() << " cells, the board needs " << nodes << endl;
+            return false;
+        }
+        links = topology.table();
+        for (int &link : links)
+        {
+            if (link == FlowTopology::NONE)
+            {
+                link = wall;
+            }
+        }
+        colors = 0;
+        for (int i = 0; i < nodes; i++)
+        {
+            if (cells[i] > colors)
+            {
+                colors = cells[i];
+            }
+        }
+        board.assign(nodes + 1, 0);
+        board[wall] = WALL;
+        heads.assign(colors + 1, -1);
+        targets.assign(colors + 1, -1);
+        done.assign(colors + 1, false);
+        region.assign(board.size(), 0);
+        required.assign(board.size(), 0);
+        pending.assign(colors + 1, 0);
+        empty = 0;
+        for (int idx = 0; idx < nodes; idx++)
+        {
+            int value = cells[idx];
+            if (value < 0)
+            {
+                cerr << "Invalid cell value " << value << " in puzzle" << endl;
+                return false;
+            }
+            board[idx] = value;
+            if (value == 0)
+            {
+                empty++;
+            }
+            else if (heads[value] == -1)
+            {
+                heads[value] = idx;
+            }
+            else if (targets[value] == -1)
+            {
+                targets[value] = idx;
+            }
+            else
+            {
+                cerr << "Color " << value << " has more than two endpoints" << endl;
+                return false;
+            }
+        }
+        for (int color = 1; color <= colors; color++)
+        {
+            if (targets[color] == -1)
+            {
+                cerr << "Color " << color << " does not have two endpoints" << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Method to require that solutions keep the colors a player has already drawn.
+    // drawn has one value per node like the puzzle; 0 leaves a node free, endpoints are ignored, and an empty vector clears all constraints.
+    void constrain(const vector<int> &drawn)
+    {
+        fill(required.begin(), required.end(), 0);
+        fill(pending.begin(), pending.end(), 0);
+        for (int i = 0; i < (int)drawn.size() && i < nodes; i++)
+        {
+            if (board[i] == 0 && drawn[i] > 0 && drawn[i] <= colors)
+            {
+                required[i] = drawn[i];
+                pending[drawn[i]]++;
+            }
+        }
+    }
+
+    // Method to search for up to maxCount solutions, giving up after nodeLimit expansions or
+    // timeLimit milliseconds (-1 for no limit); either way exhausted() reports that the search was cut short
+    int solve(int maxCount = 1, long long limit = -1, double timeLimitMs = -1)
+    {
+        stats = SolverStats();
+        found = 0;
+        maxSolutions = maxCount;
+        nodeLimit = limit;
+        timeLimit = timeLimitMs;
+        started = chrono::steady_clock::now();
+        aborted = false;
+        depth = 0;
+        solutionCells.clear();
+        search();
+        return found;
+    }
+
+    // Method to expand the search tree `depth` moves deep and save every branch still open there as a copy of this
+    // solver in tasks, instead of searching it. Solutions above that depth are found as usual; returns their number.
+    int split(int depth, int maxCount, vector<FlowSolver> &tasks)
+    {
+        tasks.clear();
+        splitDepth = depth;
+        splitTasks = &tasks;
+        int result = solve(maxCount);
+        splitDepth = -1;
+        splitTasks = NULL;
+        for (FlowSolver &task : tasks)
+        {
+            task.splitDepth = -1;
+            task.splitTasks = NULL;
+        }
+        return result;
+    }
+
+    // Method to link solvers working on branches of one tree: any of them can stop the others through stop,
+    // and the node budget and solution count apply to all of them together
+    void share(atomic<bool> *stop, atomic<long long> *nodes, atomic<int> *solutions)
+    {
+        cancel = stop;
+        sharedNodes = nodes;
+        sharedFound = solutions;
+    }
+
+    // True when the last solve() stopped because it ran out of its node budget
+    bool exhausted() const
+    {
+        return aborted;
+    }
+
+    // Colors of every node in the first solution found by the last solve()
+    const vector<int> &solution() const
+    {
+        return solutionCells;
+    }
+
+    const SolverStats &getStats() const
+    {
+        return stats;
+    }
+
+    int getColors() const
+    {
+        return colors;
+    }
+
+private:
+    int nodes;  // board nodes, not counting the WALL node
+    int degree; // neighbor table entries per node
+    int wall;   // index of the WALL node every off-board neighbor points at
+    int colors;
+    int empty; // empty cells left on the board
+    vector<int> board;
+    vector<int> heads;   // current tip of each color's path, grown from its first endpoint
+    vector<int> targets; // the endpoint each path is heading to
+    vector<bool> done;
+    vector<int> region; // scratch labels for the connectivity check
+    vector<int> frontier;
+    vector<bool> served; // regions some unfinished color can pass through
+    vector<int> links;   // degree entries per node, off-board neighbors replaced by wall
+    int found;
+    int maxSolutions;
+    long long nodeLimit;
+    double timeLimit; // milliseconds
+    chrono::steady_clock::time_point started;
+    bool aborted;
+    vector<int> required; // color a cell must take to match the player's drawing, 0 when free
+    vector<int> pending;  // required cells each color has not covered yet
+    int depth; // moves on the current search path
+    int splitDepth;              // depth at which split() saves branches, -1 when not splitting
+    vector<FlowSolver> *splitTasks;
+    atomic<bool> *cancel;        // set when a linked solver has finished the shared search
+    atomic<long long> *sharedNodes;
+    atomic<int> *sharedFound;
+    SolverStats stats;
+    vector<int> solutionCells;
+
+    // Method to check whether a cell can still be part of some unfinished path
+    bool isOpen(int cell) const
+    {
+        int value = board[cell];
+        if (value == 0)
+        {
+            return true;
+        }
+        return value > 0 && !done[value] && (heads[value] == cell || targets[value] == cell);
+    }
+
+    // Method to count the moves still available to a color
+    int countMoves(int color) const
+    {
+        int moves = 0;
+        const int *around = &links[heads[color] * degree];
+        for (int p = 0; p < degree; p++)
+        {
+            int next = around[p];
+            if (board[next] == 0 || next == targets[color])
+            {
+                moves++;
+            }
+        }
+        return moves;
+    }
+
+    // An empty cell will be the middle of some path, so it needs at least two open neighbors
+    bool isDeadEnd(int cell) const
+    {
+        int open = 0;
+        const int *around = &links[cell * degree];
+        for (int p = 0; p < degree; p++)
+        {
+            if (isOpen(around[p]))
+            {
+                open++;
+            }
+        }
+        return open < 2;
+    }
+
+    // Method to check the empty neighbors of a cell whose state just changed
+    bool strandsNeighbor(int cell) const
+    {
+        const int *around = &links[cell * degree];
+        for (int p = 0; p < degree; p++)
+        {
+            int next = around[p];
+            if (board[next] == 0 && isDeadEnd(next))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Every unfinished color needs an empty region touching both its head and target,
+    // and every empty region needs some color that can pass through it
+    bool isFeasible()
+    {
+        fill(region.begin(), region.end(), 0);
+        int regions = 0;
+        for (int cell = 0; cell < nodes; cell++)
+        {
+            if (board[cell] != 0 || region[cell] != 0)
+            {
+                continue;
+            }
+            regions++;
+            region[cell] = regions;
+            frontier.clear();
+            frontier.push_back(cell);
+            while (!frontier.empty())
+            {
+                int current = frontier.back();
+                frontier.pop_back();
+                const int *around = &links[current * degree];
+                for (int p = 0; p < degree; p++)
+                {
+                    int next = around[p];
+                    if (board[next] == 0 && region[next] == 0)
+                    {
+                        region[next] = regions;
+                        frontier.push_back(next);
+                    }
+                }
+            }
+        }
+        served.assign(regions + 1, false);
+        for (int color = 1; color <= colors; color++)
+        {
+            if (done[color])
+            {
+                continue;
+            }
+            bool reachable = false;
+            const int *fromHead = &links[heads[color] * degree];
+            const int *fromTarget = &links[targets[color] * degree];
+            for (int p = 0; p < degree; p++)
+            {
+                int next = fromHead[p];
+                if (next == targets[color])
+                {
+                    reachable = true;
+                }
+                int label = board[next] == 0 ? region[next] : 0;
+                if (label == 0)
+                {
+                    continue;
+                }
+                for (int q = 0; q < degree; q++)
+                {
+                    int other = fromTarget[q];
+                    if (board[other] == 0 && region[other] == label)
+                    {
+                        served[label] = true;
+                        reachable = true;
+                    }
+                }
+            }
+            if (!reachable)
+            {
+                return false;
+            }
+        }
+        for (int label = 1; label <= regions; label++)
+        {
+            if (!served[label])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Method to count a solution, keeping the first one; returns true once enough solutions have been found
+    bool recordSolution()
+    {
+        found++;
+        if (found == 1)
+        {
+            solutionCells.assign(board.begin(), board.begin() + nodes);
+        }
+        if (sharedFound != NULL)
+        {
+            if (sharedFound->fetch_add(1) + 1 < maxSolutions)
+            {
+                return false;
+            }
+            cancel->store(true);
+            return true;
+        }
+        return found >= maxSolutions;
+    }
+
+    // Depth-first search that always extends the color with the fewest moves; returns true to stop searching
+    bool search()
+    {
+        stats.nodes++;
+        if (nodeLimit >= 0 && stats.nodes > nodeLimit)
+        {
+            aborted = true;
+            return true;
+        }
+        if (cancel != NULL && cancel->load(memory_order_relaxed))
+        {
+            return true;
+        }
+        // Linked solvers draw on one node budget, topped up 256 nodes at a time
+        if (sharedNodes != NULL && nodeLimit >= 0 && (stats.nodes & 255) == 0 && sharedNodes->fetch_add(256) + 256 > nodeLimit)
+        {
+            aborted = true;
+            cancel->store(true);
+            return true;
+        }
+        // The clock is only read every 256 nodes, which keeps the check off the profile
+        if (timeLimit >= 0 && (stats.nodes & 255) == 0 &&
+            chrono::duration<double, milli>(chrono::steady_clock::now() - started).count() > timeLimit)
+        {
+            aborted = true;
+            return true;
+        }
+        stats.maxDepth = max(stats.maxDepth, depth);
+        if (splitTasks != NULL && depth == splitDepth)
+        {
+            splitTasks->push_back(*this);
+            return false;
+        }
+        int best = -1;
+        int bestMoves = degree + 1;
+        for (int color = 1; color <= colors; color++)
+        {
+            if (done[color])
+            {
+                continue;
+            }
+            int moves = countMoves(color);
+            if (moves == 0)
+            {
+                return false;
+            }
+            if (moves < bestMoves)
+            {
+                best = color;
+                bestMoves = moves;
+            }
+        }
+        if (best == -1)
+        {
+            // All paths are connected; it is only a solution if no cell was left uncovered
+            if (empty == 0)
+            {
+                return recordSolution();
+            }
+            return false;
+        }
+        if (!isFeasible())
+        {
+            return false;
+        }
+        int head = heads[best];
+        const int *around = &links[head * degree];
+        for (int p = 0; p < degree; p++)
+        {
+            int next = around[p];
+            bool stop = false;
+            if (next == targets[best])
+            {
+                if (pending[best] > 0)
+                {
+                    continue; // connecting now would leave some of this color's drawn cells uncovered
+                }
+                done[best] = true;
+                depth++;
+                stop = !strandsNeighbor(head) && !strandsNeighbor(next) && search();
+                depth--;
+                done[best] = false;
+            }
+            else if (board[next] == 0 && (required[next] == 0 || required[next] == best))
+            {
+                board[next] = best;
+                heads[best] = next;
+                empty--;
+                pending[best] -= required[next] == best;
+                depth++;
+                stop = !strandsNeighbor(head) && !strandsNeighbor(next) && search();
+                depth--;
+                pending[best] += required[next] == best;
+                board[next] = 0;
+                heads[best] = head;
+                empty++;
+            }
+            else
+            {
+                continue;
+            }
+            if (stop)
+            {
+                return true;
+            }
+            stats.backtracks++;
+        }
+        return false;
+    }
+};
+#endif
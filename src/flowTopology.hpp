@@ -0,0 +1,265 @@
+#ifndef FLOW_TOPOLOGY_H
+#define FLOW_TOPOLOGY_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// How the cells of a board connect. Whatever the board shape, it is turned into one flat neighbor table when a
+// level is loaded, so the solver, the input code and the renderer all walk the same precomputed arrays.
+// Paths run through nodes: node n < cells() is cell n (row-major), and every bridge cell adds a second node after
+// the cells, so that a horizontal and a vertical path can both cross it.
+// Neighbors are listed so that neighbors(node)[degree() - 1 - p] lies opposite neighbors(node)[p].
+class FlowTopology
+{
+public:
+    enum Kind
+    {
+        SQUARE, // four neighbors: up, left, right, down
+        HEX,    // six neighbors: odd rows are shifted half a cell right, like a brick wall
+        TORUS   // four neighbors, wrapping around the board edges
+    };
+    enum { NONE = -1, MAX_DEGREE = 6 };
+
+    FlowTopology() : kind(SQUARE), rows(0), cols(0), neighborCount(4) {}
+
+    // Method to build the neighbor table. Bridge cells can only be used on SQUARE and TORUS boards.
+    bool build(Kind k, int r, int c, const vector<int> &bridgeCells = vector<int>())
+    {
+        if (r <= 0 || c <= 0 || (k == TORUS && (r < 3 || c < 3)))
+        {
+            cerr << "Board of " << r << "x" << c << " cells is too small for this topology" << endl;
+            return false;
+        }
+        if (k == HEX && !bridgeCells.empty())
+        {
+            cerr << "Bridges need a square or torus board" << endl;
+            return false;
+        }
+        kind = k;
+        rows = r;
+        cols = c;
+        neighborCount = kind == HEX ? 6 : 4;
+        int cells = rows * cols;
+        crossings.assign(cells, NONE);
+        owners.clear();
+        for (int i = 0; i < cells; i++)
+        {
+            owners.push_back(i);
+        }
+        for (int cell : bridgeCells)
+        {
+            if (cell < 0 || cell >= cells || crossings[cell] != NONE)
+            {
+                cerr << "Invalid bridge cell " << cell << endl;
+                return false;
+            }
+            crossings[cell] = owners.size();
+            owners.push_back(cell);
+        }
+        adjacency.assign(owners.size() * neighborCount, NONE);
+        for (int row = 0; row < rows; row++)
+        {
+            for (int col = 0; col < cols; col++)
+            {
+                int *entry = &adjacency[(row * cols + col) * neighborCount];
+                if (kind == HEX)
+                {
+                    // The row above and below overlap the cell at two columns, shifted by the row parity
+                    int left = col - (row % 2 == 0 ? 1 : 0);
+                    entry[0] = at(row - 1, left);
+                    entry[1] = at(row - 1, left + 1);
+                    entry[2] = at(row, col - 1);
+                    entry[3] = at(row, col + 1);
+                    entry[4] = at(row + 1, left);
+                    entry[5] = at(row + 1, left + 1);
+                }
+                else
+                {
+                    entry[0] = at(row - 1, col);
+                    entry[1] = at(row, col - 1);
+                    entry[2] = at(row, col + 1);
+                    entry[3] = at(row + 1, col);
+                }
+            }
+        }
+        // A bridge cell keeps left and right for itself and hands up and down to its second node;
+        // vertical steps into a bridge then have to land on that second node
+        for (int cell : bridgeCells)
+        {
+            int *across = &adjacency[cell * 4];
+            int *down = &adjacency[crossings[cell] * 4];
+            down[0] = across[0];
+            down[3] = across[3];
+            across[0] = across[3] = NONE;
+        }
+        for (int node = 0; node < nodes() && !bridgeCells.empty(); node++)
+        {
+            int *entry = &adjacency[node * 4];
+            for (int p = 0; p < 4; p += 3)
+            {
+                if (entry[p] != NONE && crossings[entry[p]] != NONE)
+                {
+                    entry[p] = crossings[entry[p]];
+                }
+            }
+        }
+        return true;
+    }
+
+    // Method to turn a topology name (square, hex or torus) into its kind
+    static bool parse(const string &name, Kind &out)
+    {
+        const char *names[] = {"square", "hex", "torus"};
+        for (int k = 0; k < 3; k++)
+        {
+            if (name.compare(0, strlen(names[k]), names[k]) == 0)
+            {
+                out = (Kind)k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Kind getKind() const
+    {
+        return kind;
+    }
+    int getRows() const
+    {
+        return rows;
+    }
+    int getCols() const
+    {
+        return cols;
+    }
+    int cells() const
+    {
+        return rows * cols;
+    }
+    int nodes() const
+    {
+        return owners.size();
+    }
+
+    // Entries per node in the neighbor table
+    int degree() const
+    {
+        return neighborCount;
+    }
+
+    // The degree() neighbors of a node, NONE where the board ends
+    const int *neighbors(int node) const
+    {
+        return &adjacency[node * neighborCount];
+    }
+
+    // The whole table, degree() entries per node, for solvers that keep their own copy
+    const vector<int> &table() const
+    {
+        return adjacency;
+    }
+
+    // Cell a node lies in
+    int cellOf(int node) const
+    {
+        return owners[node];
+    }
+
+    // Second node of a bridge cell, NONE for ordinary cells
+    int crossing(int cell) const
+    {
+        return crossings[cell];
+    }
+
+    // Method to get the top-left pixel of a cell when cells are cellPixels wide
+    void origin(int cell, int cellPixels, int &x, int &y) const
+    {
+        int row = cell / cols;
+        x = (cell % cols) * cellPixels + (kind == HEX && row % 2 == 1 ? cellPixels / 2 : 0);
+        y = row * cellPixels;
+    }
+
+    // Size of the drawn board in pixels
+    int pixelWidth(int cellPixels) const
+    {
+        return cols * cellPixels + (kind == HEX && rows > 1 ? cellPixels / 2 : 0);
+    }
+    int pixelHeight(int cellPixels) const
+    {
+        return rows * cellPixels;
+    }
+
+    // Method to find the cell under a pixel relative to the board's top-left corner; NONE when there is none.
+    // On a torus the cell-wide strip around the board wraps to the opposite edge, so strokes can be dragged across it.
+    int cellAt(int x, int y, int cellPixels) const
+    {
+        if (kind == TORUS)
+        {
+            x = wrap(x, cols * cellPixels, cellPixels);
+            y = wrap(y, rows * cellPixels, cellPixels);
+        }
+        if (x < 0 || y < 0)
+        {
+            return NONE;
+        }
+        int row = y / cellPixels;
+        int shift = kind == HEX && row % 2 == 1 ? cellPixels / 2 : 0;
+        if (row >= rows || x < shift)
+        {
+            return NONE;
+        }
+        int col = (x - shift) / cellPixels;
+        return col < cols ? row * cols + col : NONE;
+    }
+
+    // Squared distance between two cell centers in half-cell units, for steering towards a cell
+    int distance(int a, int b) const
+    {
+        int ax, ay, bx, by;
+        origin(a, 2, ax, ay);
+        origin(b, 2, bx, by);
+        return (ax - bx) * (ax - bx) + (ay - by) * (ay - by);
+    }
+
+private:
+    Kind kind;
+    int rows, cols;
+    int neighborCount;
+    vector<int> adjacency; // neighborCount entries per node
+    vector<int> owners;    // cell of each node
+    vector<int> crossings; // second node of each bridge cell, NONE elsewhere
+
+    // Method to move a coordinate within one cell outside [0, length) to the other side
+    static int wrap(int value, int length, int cellPixels)
+    {
+        if (value < 0 && value >= -cellPixels)
+        {
+            return value + length;
+        }
+        if (value >= length && value < length + cellPixels)
+        {
+            return value - length;
+        }
+        return value;
+    }
+
+    // Cell at a row and column, wrapping on a torus; NONE off the board
+    int at(int row, int col) const
+    {
+        if (kind == TORUS)
+        {
+            row = (row + rows) % rows;
+            col = (col + cols) % cols;
+        }
+        if (row < 0 || col < 0 || row >= rows || col >= cols)
+        {
+            return NONE;
+        }
+        return row * cols + col;
+    }
+};
+#endif
@@ -0,0 +1,117 @@
+#ifndef GAP_BUFFER_H
+#define GAP_BUFFER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Bytes of text with an unused gap kept where the last edit happened.
+// Typing and deleting at the same place only move the gap's edges, so they are O(1); moving the edit point
+// costs a copy of the bytes between the old and new points, and the gap doubles when it fills, so a run of edits
+// costs O(1) amortized per byte.
+class GapBuffer
+{
+public:
+    GapBuffer() : gapStart(0), gapEnd(0) {}
+
+    size_t size() const
+    {
+        return bytes.size() - (gapEnd - gapStart);
+    }
+
+    char operator[](size_t i) const
+    {
+        return i < gapStart ? bytes[i] : bytes[i + (gapEnd - gapStart)];
+    }
+
+    // Method to insert n bytes before position pos
+    void insert(size_t pos, const char *text, size_t n)
+    {
+        if (n == 0)
+        {
+            return;
+        }
+        moveGap(pos);
+        if (gapEnd - gapStart < n)
+        {
+            grow(n);
+        }
+        memcpy(&bytes[gapStart], text, n);
+        gapStart += n;
+    }
+
+    // Method to delete the n bytes starting at position pos
+    void erase(size_t pos, size_t n)
+    {
+        moveGap(pos);
+        gapEnd += n;
+    }
+
+    // Method to copy the n bytes starting at pos into out
+    void copy(size_t pos, size_t n, string &out) const
+    {
+        out.clear();
+        if (pos < gapStart)
+        {
+            size_t before = min(n, gapStart - pos);
+            out.append(&bytes[pos], before);
+            pos += before;
+            n -= before;
+        }
+        if (n > 0)
+        {
+            out.append(&bytes[pos + (gapEnd - gapStart)], n);
+        }
+    }
+
+    string text() const
+    {
+        string out;
+        copy(0, size(), out);
+        return out;
+    }
+
+    void clear()
+    {
+        bytes.clear();
+        gapStart = gapEnd = 0;
+    }
+
+private:
+    vector<char> bytes;
+    size_t gapStart, gapEnd; // the gap is bytes[gapStart, gapEnd)
+
+    // Method to move the gap so that it starts at pos
+    void moveGap(size_t pos)
+    {
+        if (pos < gapStart)
+        {
+            size_t n = gapStart - pos;
+            memmove(&bytes[gapEnd - n], &bytes[pos], n);
+            gapStart -= n;
+            gapEnd -= n;
+        }
+        else if (pos > gapStart)
+        {
+            size_t n = pos - gapStart;
+            memmove(&bytes[gapStart], &bytes[gapEnd], n);
+            gapStart += n;
+            gapEnd += n;
+        }
+    }
+
+    // Method to widen the gap to hold at least n bytes
+    void grow(size_t n)
+    {
+        size_t tail = bytes.size() - gapEnd;
+        size_t capacity = max(bytes.size() * 2, size() + n + 64);
+        bytes.resize(capacity);
+        if (tail > 0)
+        {
+            memmove(&bytes[capacity - tail], &bytes[gapEnd], tail);
+        }
+        gapEnd = capacity - tail;
+    }
+};
+#endif
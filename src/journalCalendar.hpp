@@ -0,0 +1,152 @@
+#ifndef JOURNAL_CALENDAR_H
+#define JOURNAL_CALENDAR_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include "journalTimeline.hpp"
+#include "textRenderer.hpp"
+using namespace std;
+
+const int CALENDAR_CELL_WIDTH = 50;
+const int CALENDAR_CELL_HEIGHT = 40;
+
+// A month of the journal laid out as a calendar: a title row with arrows to the months before and after, a row of
+// weekday initials, then one cell per day with the days that have entries filled in. The cells are drawn from the
+// timeline's per-day counts; the entries themselves are only looked at for the day that is clicked.
+class JournalCalendar
+{
+public:
+    JournalCalendar(SDL_Rect area) : view(area), selectedDay(0)
+    {
+        time_t now = time(0);
+        tm local = *localtime(&now);
+        year = local.tm_year + 1900;
+        month = local.tm_mon + 1;
+    }
+
+    // Method to show another month, some months before (negative) or after this one
+    void shiftMonth(int months)
+    {
+        int index = year * 12 + (month - 1) + months;
+        year = index / 12;
+        month = index % 12 + 1;
+        selectedDay = 0;
+    }
+
+    bool contains(int x, int y) const
+    {
+        SDL_Point point = {x, y};
+        return SDL_PointInRect(&point, &view);
+    }
+
+    // Method to react to a click: the arrows change the month and a day cell selects that day.
+    // Returns whether a day was selected.
+    bool click(int x, int y)
+    {
+        if (y < view.y + CALENDAR_CELL_HEIGHT)
+        {
+            if (x < view.x + CALENDAR_CELL_WIDTH)
+            {
+                shiftMonth(-1);
+            }
+            else if (x >= view.x + 6 * CALENDAR_CELL_WIDTH)
+            {
+                shiftMonth(1);
+            }
+            return false;
+        }
+        int column = (x - view.x) / CALENDAR_CELL_WIDTH, row = (y - view.y) / CALENDAR_CELL_HEIGHT - 2;
+        int day = row * 7 + column - firstWeekday() + 1;
+        if (row < 0 || column < 0 || column > 6 || day < 1 || day > daysInMonth())
+        {
+            return false;
+        }
+        selectedDay = day;
+        return true;
+    }
+
+    // Method to find the times [from, to) of the selected day; false when no day is selected
+    bool selection(int64_t &from, int64_t &to) const
+    {
+        if (selectedDay == 0)
+        {
+            return false;
+        }
+        from = journalDayStart(year, month, selectedDay);
+        to = journalDayStart(year, month, selectedDay + 1);
+        return true;
+    }
+
+    // Method to find the times [from, to) of the month shown
+    void monthRange(int64_t &from, int64_t &to) const
+    {
+        from = journalDayStart(year, month, 1);
+        to = journalDayStart(year, month + 1, 1);
+    }
+
+    // Title of the month shown, such as "March 2026"
+    string title() const
+    {
+        static const char *names[] = {"January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"};
+        return string(names[month - 1]) + " " + to_string(year);
+    }
+
+    // Method to draw the month, marking the days with entries and the selected day
+    void render(SDL_Renderer *renderer, TextRenderer &glyphs, TTF_Font *font, SDL_Color color, const JournalTimeline &timeline)
+    {
+        int counts[32];
+        timeline.monthCounts(year, month, counts);
+        glyphs.draw(renderer, font, "<", view.x + 15, view.y, color);
+        glyphs.draw(renderer, font, ">", view.x + 6 * CALENDAR_CELL_WIDTH + 15, view.y, color);
+        string heading = title();
+        glyphs.draw(renderer, font, heading, view.x + (7 * CALENDAR_CELL_WIDTH - glyphs.width(font, heading)) / 2, view.y, color);
+        const char *weekdays[] = {"S", "M", "T", "W", "T", "F", "S"};
+        for (int column = 0; column < 7; column++)
+        {
+            glyphs.draw(renderer, font, weekdays[column], view.x + column * CALENDAR_CELL_WIDTH + 15, view.y + CALENDAR_CELL_HEIGHT, color);
+        }
+        int first = firstWeekday();
+        for (int day = 1; day <= daysInMonth(); day++)
+        {
+            int cell = first + day - 1;
+            SDL_Rect box = {view.x + cell % 7 * CALENDAR_CELL_WIDTH + 2, view.y + (cell / 7 + 2) * CALENDAR_CELL_HEIGHT + 2, CALENDAR_CELL_WIDTH - 4, CALENDAR_CELL_HEIGHT - 4};
+            SDL_Color ink = color;
+            if (counts[day] > 0)
+            {
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+                SDL_RenderFillRect(renderer, &box);
+                ink = {255, 255, 255, 255};
+            }
+            if (day == selectedDay)
+            {
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+                SDL_Rect frame = {box.x - 2, box.y - 2, box.w + 4, box.h + 4};
+                SDL_RenderDrawRect(renderer, &frame);
+            }
+            string number = to_string(day);
+            glyphs.draw(renderer, font, number, box.x + (box.w - glyphs.width(font, number)) / 2, box.y, ink);
+        }
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    }
+
+private:
+    SDL_Rect view;
+    int year, month;
+    int selectedDay; // 0 when no day is selected
+
+    // Column (0 is Sunday) of the month's first day
+    int firstWeekday() const
+    {
+        time_t first = (time_t)journalDayStart(year, month, 1);
+        return localtime(&first)->tm_wday;
+    }
+
+    int daysInMonth() const
+    {
+        static const int lengths[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        return month == 2 && leap ? 29 : lengths[month - 1];
+    }
+};
+#endif
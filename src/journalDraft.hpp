@@ -0,0 +1,180 @@
+#ifndef JOURNAL_DRAFT_H
+#define JOURNAL_DRAFT_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "journalStore.hpp"
+#include "threadPool.hpp"
+using namespace std;
+
+const Uint32 JOURNAL_DRAFT_IDLE_MS = 2000; // pause in typing after which the draft is saved
+const uint32_t JOURNAL_DRAFT_EDITS = 100;  // edits after which it is saved even while typing goes on
+
+// The entry being written, kept in a draft file so that closing the window mid-entry loses at most a couple of
+// seconds of typing. The game thread only notes edits and hands over a copy of the text; a writer thread writes it
+// to a temporary file, syncs it and renames it over the draft, so the draft on disk is always a whole one. Only the
+// newest text waiting to be written is kept: a slow disk skips versions instead of queueing them.
+class JournalDraft
+{
+public:
+    JournalDraft(const string &file) : path(file), seen(0), saved(0), lastEdit(0), waiting(false), removeNext(false), writing(false), writer(1)
+    {
+        lock = SDL_CreateMutex();
+    }
+    ~JournalDraft()
+    {
+        writer.wait();
+        SDL_DestroyMutex(lock);
+    }
+
+    // Method to read the draft left by the last session; false when there is none
+    bool load(string &text)
+    {
+        text.clear();
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            return false;
+        }
+        char chunk[4096];
+        size_t got;
+        while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            text.append(chunk, got);
+        }
+        fclose(file);
+        return !text.empty();
+    }
+
+    // Method to call once per frame with the editor's version; notes when the text last changed
+    void edited(uint32_t version)
+    {
+        if (version != seen)
+        {
+            seen = version;
+            lastEdit = SDL_GetTicks();
+        }
+    }
+
+    // True when the text has changed since the draft was last handed to the writer
+    bool unsaved() const
+    {
+        return seen != saved;
+    }
+
+    // True when the text has been left alone for JOURNAL_DRAFT_IDLE_MS, or has had JOURNAL_DRAFT_EDITS edits since
+    // the last save
+    bool due() const
+    {
+        return unsaved() && (SDL_GetTicks() - lastEdit >= JOURNAL_DRAFT_IDLE_MS || seen - saved >= JOURNAL_DRAFT_EDITS);
+    }
+
+    // Method to hand the text to the writer; empty text removes the draft instead
+    void save(const string &text)
+    {
+        saved = seen;
+        post(text, text.empty());
+    }
+
+    // Method to note that the draft on disk already holds this version of the text, as after load
+    void markSaved(uint32_t version)
+    {
+        seen = saved = version;
+    }
+
+    // Method to remove the draft once its entry is in the journal
+    void discard(uint32_t version)
+    {
+        markSaved(version);
+        post("", true);
+    }
+
+    // Method to wait for the writer to finish, before quitting
+    void flush()
+    {
+        writer.wait();
+    }
+
+private:
+    string path;
+    uint32_t seen, saved; // editor versions last noted and last handed to the writer
+    Uint32 lastEdit;
+    SDL_mutex *lock;      // guards the fields below, which the writer thread reads
+    string next;          // newest text waiting to be written
+    bool waiting, removeNext;
+    bool writing;         // a writer job is queued or running and will pick up what is waiting
+    ThreadPool writer;    // declared last so its thread stops before the members it uses are destroyed
+
+    JournalDraft(const JournalDraft &);
+    JournalDraft &operator=(const JournalDraft &);
+
+    // Method to leave the text for the writer, starting a writer job unless one is already going
+    void post(const string &text, bool remove)
+    {
+        SDL_LockMutex(lock);
+        next = text;
+        removeNext = remove;
+        waiting = true;
+        bool start = !writing;
+        writing = true;
+        SDL_UnlockMutex(lock);
+        if (start)
+        {
+            writer.submit([this]()
+            {
+                writeWaiting();
+            });
+        }
+    }
+
+    // Runs on the writer thread: writes whatever is waiting until nothing is. The lock is never held during I/O,
+    // so the game thread never waits on the disk.
+    void writeWaiting()
+    {
+        string text;
+        while (true)
+        {
+            SDL_LockMutex(lock);
+            if (!waiting)
+            {
+                writing = false;
+                SDL_UnlockMutex(lock);
+                return;
+            }
+            text.swap(next);
+            bool remove = removeNext;
+            waiting = false;
+            SDL_UnlockMutex(lock);
+            if (remove)
+            {
+                ::remove(path.c_str());
+            }
+            else
+            {
+                write(text);
+            }
+        }
+    }
+
+    bool write(const string &text)
+    {
+        string temp = path + ".tmp";
+        FILE *file = fopen(temp.c_str(), "wb");
+        bool ok = file != NULL && fwrite(text.data(), 1, text.size(), file) == text.size() && journalFsync(file);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (!ok || !journalReplace(temp, path))
+        {
+            cerr << "Error writing journal draft: " << path << endl;
+            ::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+};
+#endif
@@ -0,0 +1,182 @@
+#ifndef JOURNAL_INDEX_H
+#define JOURNAL_INDEX_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+// Where one live journal entry's record sits in the log
+struct JournalEntry
+{
+    uint64_t offset;
+    int64_t time;
+    uint32_t id;
+    uint32_t length;
+};
+
+const int JOURNAL_CHUNK = 256; // entries per chunk; a delete moves at most this many
+
+// The live entries of a journal in log order, addressed by their position (the entry number shown to the player).
+// Entries sit in fixed chunks and a Fenwick tree over the chunk sizes turns a position into a chunk, so looking up
+// or deleting by position is O(log n) and never walks the list. Entries are only ever added at the end, so chunks
+// never split; a chunk emptied by deletes just stays empty until pack() is called.
+class JournalIndex
+{
+public:
+    JournalIndex() : count(0) {}
+
+    int size() const
+    {
+        return count;
+    }
+
+    void clear()
+    {
+        chunks.clear();
+        firstIds.clear();
+        tree.clear();
+        count = 0;
+    }
+
+    // Method to add an entry after every other one; its id must be larger than theirs
+    void push_back(const JournalEntry &entry)
+    {
+        if (chunks.empty() || (int)chunks.back().size() == JOURNAL_CHUNK)
+        {
+            chunks.push_back(vector<JournalEntry>());
+            chunks.back().reserve(JOURNAL_CHUNK);
+            firstIds.push_back(entry.id);
+            // A new Fenwick node covers the chunks (k - lowbit(k), k], all of them older than the new one
+            int k = chunks.size();
+            tree.push_back(prefix(k - 1) - prefix(k - (k & -k)));
+        }
+        chunks.back().push_back(entry);
+        add(chunks.size() - 1, 1);
+        count++;
+    }
+
+    const JournalEntry &operator[](int i) const
+    {
+        int chunk = locate(i);
+        return chunks[chunk][i];
+    }
+
+    // Method to delete the entry at a position
+    void erase(int i)
+    {
+        int chunk = locate(i);
+        chunks[chunk].erase(chunks[chunk].begin() + i);
+        add(chunk, -1);
+        count--;
+    }
+
+    // Position of the entry with an id, -1 when there is none
+    int find(uint32_t id) const
+    {
+        // Every id in chunk c is at least firstIds[c] and below firstIds[c + 1], whatever was deleted since
+        int chunk = upper_bound(firstIds.begin(), firstIds.end(), id) - firstIds.begin() - 1;
+        if (chunk < 0)
+        {
+            return -1;
+        }
+        const vector<JournalEntry> &entries = chunks[chunk];
+        vector<JournalEntry>::const_iterator it = lower_bound(entries.begin(), entries.end(), id, [](const JournalEntry &entry, uint32_t value)
+        {
+            return entry.id < value;
+        });
+        return it != entries.end() && it->id == id ? prefix(chunk) + (it - entries.begin()) : -1;
+    }
+
+    // Method to call visit(entry) for the entries at positions [first, first + n), in order; only the first
+    // one is looked up, the rest are walked straight through the chunks
+    template <typename F>
+    void forRange(int first, int n, F visit) const
+    {
+        n = min(n, count - first);
+        if (n <= 0)
+        {
+            return;
+        }
+        int i = first;
+        for (int chunk = locate(i); n > 0; chunk++, i = 0)
+        {
+            for (; i < (int)chunks[chunk].size() && n > 0; i++, n--)
+            {
+                visit(chunks[chunk][i]);
+            }
+        }
+    }
+    template <typename F>
+    void forRange(int first, int n, F visit)
+    {
+        const JournalIndex &self = *this;
+        self.forRange(first, n, [&visit](const JournalEntry &entry)
+        {
+            visit(const_cast<JournalEntry &>(entry));
+        });
+    }
+
+    // Method to rebuild the chunks full, dropping the ones deletes have emptied
+    void pack()
+    {
+        vector<JournalEntry> all;
+        all.reserve(count);
+        forRange(0, count, [&all](const JournalEntry &entry)
+        {
+            all.push_back(entry);
+        });
+        clear();
+        for (const JournalEntry &entry : all)
+        {
+            push_back(entry);
+        }
+    }
+
+private:
+    vector<vector<JournalEntry>> chunks;
+    vector<uint32_t> firstIds; // id of the first entry each chunk was given
+    vector<int> tree;          // Fenwick tree of chunk sizes; tree[k - 1] holds node k
+    int count;
+
+    // Method to add delta to the size of a chunk
+    void add(int chunk, int delta)
+    {
+        for (int k = chunk + 1; k <= (int)tree.size(); k += k & -k)
+        {
+            tree[k - 1] += delta;
+        }
+    }
+
+    // Entries in the chunks before chunk k
+    int prefix(int k) const
+    {
+        int sum = 0;
+        for (; k > 0; k -= k & -k)
+        {
+            sum += tree[k - 1];
+        }
+        return sum;
+    }
+
+    // Method to find the chunk holding position i by descending the Fenwick tree; i becomes the position within it
+    int locate(int &i) const
+    {
+        int k = 0;
+        int step = 1;
+        while (step * 2 <= (int)tree.size())
+        {
+            step *= 2;
+        }
+        for (; step > 0; step /= 2)
+        {
+            if (k + step <= (int)tree.size() && tree[k + step - 1] <= i)
+            {
+                k += step;
+                i -= tree[k - 1];
+            }
+        }
+        return k;
+    }
+};
+#endif
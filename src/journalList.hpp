@@ -0,0 +1,125 @@
+#ifndef JOURNAL_LIST_H
+#define JOURNAL_LIST_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "journalIndex.hpp"
+#include "textLayout.hpp"
+using namespace std;
+
+// A scrollable list of journal entries that only lays out the rows inside its viewport.
+// Each visible row's text is wrapped to the list's width once and the lines are reused every frame until the row
+// shows a different entry number (after an earlier entry is deleted); rows that scroll out of view are forgotten.
+// The lines are drawn from the shared glyph atlas, so a frame costs a few batched draws per visible row, however
+// long the journal is.
+class JournalList
+{
+public:
+    // The text of a row, from its entry number (1-based) and entry
+    typedef function<string(int, const JournalEntry &)> RowText;
+
+    JournalList(SDL_Rect area, int rowPixels) : view(area), rowHeight(rowPixels), scrollY(0), frame(0) {}
+
+    // Method to scroll by some pixels (positive moves down the list), staying within a list of count rows
+    void scroll(int pixels, int count)
+    {
+        scrollY = max(0, min(scrollY + pixels, maxScroll(count)));
+    }
+
+    bool contains(int x, int y) const
+    {
+        SDL_Point point = {x, y};
+        return SDL_PointInRect(&point, &view);
+    }
+
+    // Method to draw the rows of entries that fall inside the viewport
+    void render(SDL_Renderer *renderer, TextRenderer &glyphs, TextLayout &layout, TTF_Font *font, SDL_Color color, const JournalIndex &entries, const RowText &text)
+    {
+        frame++;
+        scrollY = min(scrollY, maxScroll(entries.size()));
+        int first = scrollY / rowHeight;
+        int visible = (view.h + rowHeight - 1) / rowHeight + 1;
+        int number = first + 1;
+        SDL_RenderSetClipRect(renderer, &view);
+        entries.forRange(first, visible, [&](const JournalEntry &entry)
+        {
+            Row &row = rows[entry.id];
+            if (row.number != number || row.lines.empty())
+            {
+                row.text = text(number, entry);
+                row.lines = layout.wrap(font, row.text, view.w - 10); // clear of the scroll bar
+                row.number = number;
+            }
+            row.frame = frame;
+            int y = view.y + (number - 1) * rowHeight - scrollY;
+            for (const TextLine &line : row.lines)
+            {
+                glyphs.draw(renderer, font, row.text, line.start, line.start + line.length, view.x, y, color);
+                y += glyphs.lineHeight(font);
+            }
+            number++;
+        });
+        SDL_RenderSetClipRect(renderer, NULL);
+        // Rows that were not drawn this frame have scrolled away or been deleted
+        for (unordered_map<uint32_t, Row>::iterator it = rows.begin(); it != rows.end();)
+        {
+            if (it->second.frame != frame)
+            {
+                it = rows.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        renderScrollBar(renderer, color, entries.size());
+    }
+
+    // Method to forget every cached row, for when the font or the wrap width changes
+    void clear()
+    {
+        rows.clear();
+    }
+
+private:
+    struct Row
+    {
+        int number; // entry number the lines show
+        string text;
+        vector<TextLine> lines;
+        unsigned frame; // last frame the row was drawn in
+        Row() : number(0), frame(0) {}
+    };
+    SDL_Rect view;
+    int rowHeight;
+    int scrollY; // pixels of the list above the top of the viewport
+    unsigned frame;
+    unordered_map<uint32_t, Row> rows; // cached rows by entry id
+
+    JournalList(const JournalList &);
+    JournalList &operator=(const JournalList &);
+
+    int maxScroll(int count) const
+    {
+        return max(0, count * rowHeight - view.h);
+    }
+
+    // A thin bar along the right edge shows which part of a list taller than the viewport is in view
+    void renderScrollBar(SDL_Renderer *renderer, SDL_Color color, int count)
+    {
+        int total = count * rowHeight;
+        if (total <= view.h)
+        {
+            return;
+        }
+        SDL_Rect bar = {view.x + view.w - 6, view.y + (int)((long long)scrollY * view.h / total), 4, max(10, (int)((long long)view.h * view.h / total))};
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRect(renderer, &bar);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    }
+};
+#endif
@@ -0,0 +1,495 @@
+#ifndef JOURNAL_MOOD_H
+#define JOURNAL_MOOD_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+#include "journalStore.hpp"
+#include "journalTimeline.hpp"
+using namespace std;
+
+// Mood file, version 1. Numbers are little-endian.
+//
+//   header (20 bytes): "JMOD", version, entry count, largest id scored, FNV-1a checksum of the records
+//   records (12 bytes each, in id order): entry id, sum of its word scores (signed), lexicon words found
+//
+// Like the search index it is only a cache: entries written or deleted since it was saved are caught up when it
+// is opened, and it is scored afresh when it is missing or damaged.
+
+const uint32_t JOURNAL_MOOD_VERSION = 1;
+const int JOURNAL_MOOD_HEADER = 20;
+const int JOURNAL_MOOD_RECORD = 12;
+const int MOOD_NEGATE = 100;      // lexicon score of words that flip the sign of the next scored word
+const int MOOD_NEGATE_REACH = 3;  // words after a negation that it can still flip
+const int MOOD_WORD_MAX = 16;     // longest word looked up, in bytes
+
+struct MoodWord
+{
+    const char *word;
+    int score;
+};
+
+// Valence of common words in journal writing, from -3 (very negative) to 3 (very positive).
+// Words are lowercase with apostrophes left out, the way the tokenizer hands them over.
+const MoodWord moodLexicon[] = {
+    {"accomplished", 2}, {"amazing", 3}, {"awesome", 3}, {"beautiful", 3}, {"best", 3}, {"better", 1},
+    {"blessed", 2}, {"calm", 2}, {"celebrate", 3}, {"celebrated", 3}, {"cheerful", 2}, {"comfortable", 1},
+    {"confident", 2}, {"content", 2}, {"delighted", 3}, {"easy", 1}, {"energetic", 2}, {"energized", 2},
+    {"enjoy", 2}, {"enjoyed", 2}, {"excited", 3}, {"fantastic", 3}, {"fine", 1}, {"free", 1},
+    {"friendly", 1}, {"fun", 2}, {"glad", 2}, {"good", 2}, {"grateful", 3}, {"great", 3},
+    {"happy", 3}, {"healthy", 2}, {"helpful", 1}, {"hope", 1}, {"hopeful", 2}, {"inspired", 2},
+    {"joy", 3}, {"joyful", 3}, {"kind", 1}, {"laugh", 2}, {"laughed", 2}, {"love", 3},
+    {"loved", 3}, {"lovely", 2}, {"loving", 2}, {"motivated", 2}, {"nice", 2}, {"optimistic", 2},
+    {"peace", 2}, {"peaceful", 2}, {"pleased", 2}, {"productive", 2}, {"progress", 1}, {"proud", 2},
+    {"refreshed", 2}, {"relaxed", 2}, {"relief", 2}, {"relieved", 2}, {"rested", 2}, {"safe", 1},
+    {"satisfied", 2}, {"smile", 2}, {"smiled", 2}, {"strong", 1}, {"success", 2}, {"successful", 2},
+    {"supported", 2}, {"sweet", 1}, {"thankful", 2}, {"thanks", 2}, {"warm", 1}, {"win", 2},
+    {"wonderful", 3}, {"won", 2}, {"yay", 2},
+
+    {"afraid", -2}, {"alone", -1}, {"angry", -3}, {"annoyed", -2}, {"anxiety", -2}, {"anxious", -2},
+    {"argument", -2}, {"ashamed", -2}, {"awful", -3}, {"bad", -2}, {"bored", -1}, {"boring", -1},
+    {"broken", -2}, {"burnout", -3}, {"conflict", -2}, {"cranky", -2}, {"cried", -2}, {"cry", -2},
+    {"crying", -2}, {"depressed", -3}, {"depression", -3}, {"difficult", -1}, {"disappointed", -2}, {"drained", -2},
+    {"dread", -2}, {"embarrassed", -2}, {"empty", -1}, {"exhausted", -2}, {"fail", -2}, {"failed", -2},
+    {"failure", -2}, {"fear", -2}, {"fight", -2}, {"fought", -2}, {"frustrated", -2}, {"frustrating", -2},
+    {"grief", -2}, {"grieving", -2}, {"grumpy", -2}, {"guilty", -2}, {"hard", -1}, {"hate", -3},
+    {"hated", -3}, {"heartbroken", -3}, {"helpless", -2}, {"hopeless", -3}, {"horrible", -3}, {"hurt", -2},
+    {"ill", -2}, {"insomnia", -2}, {"irritated", -2}, {"jealous", -2}, {"lonely", -2}, {"lost", -1},
+    {"mad", -2}, {"miserable", -3}, {"nervous", -2}, {"numb", -1}, {"overwhelmed", -2}, {"pain", -2},
+    {"painful", -2}, {"panic", -3}, {"problem", -1}, {"problems", -1}, {"regret", -2}, {"rejected", -2},
+    {"restless", -1}, {"sad", -2}, {"scared", -2}, {"shame", -2}, {"sick", -2}, {"sleepless", -2},
+    {"stress", -2}, {"stressed", -2}, {"stressful", -2}, {"struggle", -2}, {"struggling", -2}, {"tears", -2},
+    {"tense", -2}, {"terrible", -3}, {"tired", -1}, {"trouble", -2}, {"ugh", -2}, {"unhappy", -2},
+    {"upset", -2}, {"worried", -2}, {"worry", -2}, {"worse", -2}, {"worst", -3}, {"worthless", -3},
+
+    {"cant", MOOD_NEGATE}, {"couldnt", MOOD_NEGATE}, {"didnt", MOOD_NEGATE}, {"doesnt", MOOD_NEGATE},
+    {"dont", MOOD_NEGATE}, {"isnt", MOOD_NEGATE}, {"never", MOOD_NEGATE}, {"no", MOOD_NEGATE},
+    {"not", MOOD_NEGATE}, {"wasnt", MOOD_NEGATE}, {"wont", MOOD_NEGATE}, {"wouldnt", MOOD_NEGATE},
+};
+
+// Second hash of a word, spreading the first (FNV-1a) hash mixed with a bucket's seed over the slots
+inline uint32_t moodMix(uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// The mood lexicon in a perfect hash table, built once with hash-and-displace: words are grouped into buckets by
+// their hash, and each bucket gets a seed that puts all its words in empty slots. A lookup is then two hashes,
+// one slot and one compare, whatever the word, and words that are not in the lexicon cost the same.
+class MoodLexicon
+{
+public:
+    static const MoodLexicon &instance()
+    {
+        static MoodLexicon lexicon;
+        return lexicon;
+    }
+
+    // Score of a lowercase word given its FNV-1a hash; 0 when it is not in the lexicon
+    int score(uint32_t hash, const char *word, int length) const
+    {
+        const Slot &slot = slots[moodMix(hash ^ seeds[hash % seeds.size()]) & mask];
+        return slot.length == length && memcmp(slot.word, word, length) == 0 ? slot.score : 0;
+    }
+
+    static uint32_t hash(const char *word, int length)
+    {
+        uint32_t hash = 2166136261u;
+        for (int i = 0; i < length; i++)
+        {
+            hash = (hash ^ (unsigned char)word[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+private:
+    struct Slot
+    {
+        const char *word;
+        int length, score; // length is 0 in empty slots, so they match no word
+    };
+    vector<uint32_t> seeds; // one per bucket
+    vector<Slot> slots;
+    uint32_t mask;
+
+    MoodLexicon()
+    {
+        int n = sizeof(moodLexicon) / sizeof(moodLexicon[0]);
+        int size = 1;
+        while (size < 2 * n)
+        {
+            size *= 2;
+        }
+        mask = size - 1;
+        Slot empty = {"", 0, 0};
+        slots.assign(size, empty);
+        seeds.assign(n / 2 + 1, 0);
+        vector<vector<int>> buckets(seeds.size());
+        vector<uint32_t> hashes(n);
+        for (int i = 0; i < n; i++)
+        {
+            hashes[i] = hash(moodLexicon[i].word, strlen(moodLexicon[i].word));
+            buckets[hashes[i] % seeds.size()].push_back(i);
+        }
+        // The fullest buckets are placed first, while most slots are still free
+        vector<int> order(seeds.size());
+        for (int b = 0; b < (int)order.size(); b++)
+        {
+            order[b] = b;
+        }
+        sort(order.begin(), order.end(), [&buckets](int a, int b) { return buckets[a].size() > buckets[b].size(); });
+        vector<uint32_t> taken;
+        for (int b : order)
+        {
+            for (uint32_t seed = 1; !buckets[b].empty(); seed++)
+            {
+                taken.clear();
+                for (int i : buckets[b])
+                {
+                    uint32_t slot = moodMix(hashes[i] ^ seed) & mask;
+                    if (slots[slot].length != 0 || find(taken.begin(), taken.end(), slot) != taken.end())
+                    {
+                        break;
+                    }
+                    taken.push_back(slot);
+                }
+                if (taken.size() == buckets[b].size())
+                {
+                    seeds[b] = seed;
+                    for (size_t k = 0; k < taken.size(); k++)
+                    {
+                        const MoodWord &word = moodLexicon[buckets[b][k]];
+                        Slot filled = {word.word, (int)strlen(word.word), word.score};
+                        slots[taken[k]] = filled;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    MoodLexicon(const MoodLexicon &);
+    MoodLexicon &operator=(const MoodLexicon &);
+};
+
+// Mood of one entry: the sum of its words' scores and how many of its words were in the lexicon
+struct MoodScore
+{
+    int32_t sum;
+    uint32_t hits;
+};
+
+// Mood of one day: its entries, and their scores added up
+struct MoodDay
+{
+    int entries;
+    int32_t sum;
+    uint32_t hits;
+};
+
+// Method to score text against the lexicon in one pass over its bytes, with no allocation.
+// Words are runs of letters, digits and non-ASCII bytes, lowercased, with apostrophes (' and the UTF-8 right
+// quote) left out so "don't" is "dont". A negation flips the next scored word within MOOD_NEGATE_REACH words,
+// unless punctuation ends the clause first.
+inline MoodScore moodScore(const string &text)
+{
+    const MoodLexicon &lexicon = MoodLexicon::instance();
+    MoodScore result = {0, 0};
+    char word[MOOD_WORD_MAX];
+    int length = 0, negated = 0;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i <= text.size(); i++)
+    {
+        unsigned char c = i < text.size() ? text[i] : ' ';
+        if (c == '\'' || (c == 0xE2 && text.compare(i, 3, "\xE2\x80\x99") == 0))
+        {
+            i += c == '\'' ? 0 : 2;
+            continue;
+        }
+        if (c >= 'A' && c <= 'Z')
+        {
+            c += 'a' - 'A';
+        }
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80)
+        {
+            if (length < MOOD_WORD_MAX)
+            {
+                word[length] = c;
+            }
+            length++;
+            hash = (hash ^ c) * 16777619u;
+            continue;
+        }
+        if (length > 0)
+        {
+            int score = length <= MOOD_WORD_MAX ? lexicon.score(hash, word, length) : 0;
+            if (score == MOOD_NEGATE)
+            {
+                negated = MOOD_NEGATE_REACH;
+            }
+            else if (score != 0)
+            {
+                result.sum += negated > 0 ? -score : score;
+                result.hits++;
+                negated = 0;
+            }
+            else if (negated > 0)
+            {
+                negated--;
+            }
+            length = 0;
+            hash = 2166136261u;
+        }
+        if (c == '.' || c == ',' || c == '!' || c == '?' || c == ';' || c == '\n')
+        {
+            negated = 0;
+        }
+    }
+    return result;
+}
+
+// Mood of the journal: every entry is scored once, when it is saved, and its score is added to its day's totals.
+// A trend reads the per-day totals only, so drawing one never touches the entries.
+class JournalMood
+{
+public:
+    JournalMood() : lastScored(0) {}
+    ~JournalMood()
+    {
+        close();
+    }
+
+    // Method to load the scores saved next to a journal and catch up with the entries written or deleted since
+    bool open(const string &file, JournalStore &journal)
+    {
+        close();
+        path = file;
+        vector<MoodScore> saved;
+        bool loaded = load(saved, journal.nextEntryId());
+        if (!loaded && journal.size() > 0)
+        {
+            cerr << "Scoring journal mood: " << path << endl;
+        }
+        scores.assign(journal.size() > 0 ? journal.entry(journal.size() - 1).id + 1 : 1, MoodScore());
+        vector<int> unscored; // entry numbers whose bodies have to be read
+        int position = 0;
+        bool stale = false;
+        journal.index().forRange(0, journal.size(), [&](const JournalEntry &entry)
+        {
+            if (entry.id < saved.size() && saved[entry.id].hits != 0)
+            {
+                tally(entry.time, entry.id, saved[entry.id]);
+            }
+            else
+            {
+                stale = stale || entry.id <= lastScored; // an entry the file should have had; it is another journal's
+                unscored.push_back(position);
+            }
+            position++;
+        });
+        if (stale)
+        {
+            cerr << "Journal mood file does not match the journal: " << path << endl;
+            clear();
+            return rescore(journal);
+        }
+        string body;
+        for (int i : unscored)
+        {
+            if (journal.read(i, body))
+            {
+                add(journal.entry(i).time, journal.entry(i).id, body);
+            }
+        }
+        return true;
+    }
+
+    // Method to save the scores if they were opened from a file
+    void close()
+    {
+        if (!path.empty())
+        {
+            save();
+        }
+        path.clear();
+        clear();
+    }
+
+    // Method to score a new entry and add it to its day
+    void add(int64_t time, uint32_t id, const string &text)
+    {
+        MoodScore score = moodScore(text);
+        score.hits++; // stored as found + 1, so 0 means no entry
+        if (id >= scores.size())
+        {
+            scores.resize(max((size_t)id + 1, scores.size() * 2), MoodScore());
+        }
+        tally(time, id, score);
+        lastScored = max(lastScored, id);
+    }
+
+    void remove(int64_t time, uint32_t id)
+    {
+        if (id >= scores.size() || scores[id].hits == 0)
+        {
+            return;
+        }
+        map<int, MoodDay>::iterator day = days.find(calendarDays.dayOf(time));
+        if (day != days.end())
+        {
+            day->second.entries--;
+            day->second.sum -= scores[id].sum;
+            day->second.hits -= scores[id].hits - 1;
+            if (day->second.entries == 0)
+            {
+                days.erase(day);
+            }
+        }
+        scores[id].hits = 0;
+    }
+
+    // Totals of a local day, as year * 10000 + month * 100 + day; NULL when nothing was written that day
+    const MoodDay *day(int key) const
+    {
+        map<int, MoodDay>::const_iterator found = days.find(key);
+        return found != days.end() ? &found->second : NULL;
+    }
+
+    // Method to look up the score of a live entry; false when the id is not one
+    bool entry(uint32_t id, MoodScore &score) const
+    {
+        if (id >= scores.size() || scores[id].hits == 0)
+        {
+            return false;
+        }
+        score.sum = scores[id].sum;
+        score.hits = scores[id].hits - 1;
+        return true;
+    }
+
+private:
+    string path;
+    vector<MoodScore> scores;  // by entry id; hits is the words found + 1, or 0 when the id is not a live entry
+    map<int, MoodDay> days;    // totals per local day, by year * 10000 + month * 100 + day
+    uint32_t lastScored;       // largest id ever scored, so a saved file can be told apart from another journal's
+    JournalDayFinder calendarDays;
+
+    JournalMood(const JournalMood &);
+    JournalMood &operator=(const JournalMood &);
+
+    void clear()
+    {
+        scores.clear();
+        days.clear();
+        lastScored = 0;
+    }
+
+    // Method to record an entry's score, with hits already stored as found + 1, and add it to its day
+    void tally(int64_t time, uint32_t id, const MoodScore &score)
+    {
+        scores[id] = score;
+        MoodDay &day = days[calendarDays.dayOf(time)];
+        day.entries++;
+        day.sum += score.sum;
+        day.hits += score.hits - 1;
+    }
+
+    // Method to score every entry of the journal afresh, reading each body once
+    bool rescore(JournalStore &journal)
+    {
+        string body;
+        for (int i = 0; i < journal.size(); i++)
+        {
+            if (journal.read(i, body))
+            {
+                add(journal.entry(i).time, journal.entry(i).id, body);
+            }
+        }
+        return true;
+    }
+
+    // Method to read the saved scores by id, with hits stored as found + 1; false when the file is missing or damaged.
+    // Records are kept only for live entries, so the largest id is bounded by the journal's next id, not the file size.
+    bool load(vector<MoodScore> &saved, uint32_t nextId)
+    {
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            return false;
+        }
+        uint64_t length = journalFileSize(file);
+        vector<uint8_t> data(length);
+        rewind(file);
+        bool ok = length >= JOURNAL_MOOD_HEADER && fread(data.data(), 1, length, file) == length;
+        fclose(file);
+        if (!ok || memcmp(data.data(), "JMOD", 4) != 0 || journalGet(data.data() + 4, 4) != JOURNAL_MOOD_VERSION ||
+            (length - JOURNAL_MOOD_HEADER) != journalGet(data.data() + 8, 4) * JOURNAL_MOOD_RECORD ||
+            journalChecksum(data.data() + JOURNAL_MOOD_HEADER, length - JOURNAL_MOOD_HEADER) != journalGet(data.data() + 16, 4))
+        {
+            return false;
+        }
+        uint32_t largest = journalGet(data.data() + 12, 4);
+        if (largest >= nextId)
+        {
+            return false;
+        }
+        saved.assign(largest + 1, MoodScore());
+        for (const uint8_t *p = data.data() + JOURNAL_MOOD_HEADER; p < data.data() + length; p += JOURNAL_MOOD_RECORD)
+        {
+            uint32_t id = journalGet(p, 4);
+            if (id > largest)
+            {
+                saved.clear();
+                return false;
+            }
+            saved[id].sum = (int32_t)journalGet(p + 4, 4);
+            saved[id].hits = journalGet(p + 8, 4) + 1;
+        }
+        lastScored = largest;
+        return true;
+    }
+
+    bool save()
+    {
+        vector<uint8_t> data(JOURNAL_MOOD_HEADER);
+        uint32_t count = 0;
+        for (uint32_t id = 1; id < scores.size(); id++)
+        {
+            if (scores[id].hits != 0)
+            {
+                data.resize(data.size() + JOURNAL_MOOD_RECORD);
+                uint8_t *p = data.data() + data.size() - JOURNAL_MOOD_RECORD;
+                journalPut(p, id, 4);
+                journalPut(p + 4, (uint32_t)scores[id].sum, 4);
+                journalPut(p + 8, scores[id].hits - 1, 4);
+                count++;
+            }
+        }
+        memcpy(data.data(), "JMOD", 4);
+        journalPut(data.data() + 4, JOURNAL_MOOD_VERSION, 4);
+        journalPut(data.data() + 8, count, 4);
+        journalPut(data.data() + 12, lastScored, 4);
+        journalPut(data.data() + 16, journalChecksum(data.data() + JOURNAL_MOOD_HEADER, data.size() - JOURNAL_MOOD_HEADER), 4);
+        string temp = path + ".tmp";
+        FILE *file = fopen(temp.c_str(), "wb");
+        bool ok = file != NULL && fwrite(data.data(), 1, data.size(), file) == data.size() && journalFsync(file);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (!ok || !journalReplace(temp, path))
+        {
+            cerr << "Error writing journal mood file: " << path << endl;
+            ::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+};
+#endif
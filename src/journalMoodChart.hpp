@@ -0,0 +1,136 @@
+#ifndef JOURNAL_MOOD_CHART_H
+#define JOURNAL_MOOD_CHART_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include "journalMood.hpp"
+#include "textRenderer.hpp"
+using namespace std;
+
+const int MOOD_CHART_DAYS = 30;
+const int MOOD_CHART_TOP = 3; // average word score drawn as a full-height bar
+
+// Mood over a month of days as a bar chart: one bar per day, up for days whose entries read positive and down for
+// negative ones, sized by the average score of the lexicon words found that day. Only the mood's per-day totals are
+// read, one per bar, so drawing it costs the same whatever the size of the journal.
+class JournalMoodChart
+{
+public:
+    JournalMoodChart(SDL_Rect area) : view(area)
+    {
+        time_t now = time(0);
+        tm local = *localtime(&now);
+        year = local.tm_year + 1900;
+        month = local.tm_mon + 1;
+        day = local.tm_mday;
+        refreshDays();
+    }
+
+    // Method to show the days some days before (negative) or after the ones shown now
+    void shiftDays(int days)
+    {
+        time_t last = (time_t)journalDayStart(year, month, day + days);
+        tm local = *localtime(&last);
+        year = local.tm_year + 1900;
+        month = local.tm_mon + 1;
+        day = local.tm_mday;
+        refreshDays();
+    }
+
+    bool contains(int x, int y) const
+    {
+        SDL_Point point = {x, y};
+        return SDL_PointInRect(&point, &view);
+    }
+
+    // Method to react to a click: the arrows beside the title move the chart a whole chart's width of days
+    void click(int x, int y)
+    {
+        if (y < view.y + 40 && x < view.x + 40)
+        {
+            shiftDays(-MOOD_CHART_DAYS);
+        }
+        else if (y < view.y + 40 && x >= view.x + view.w - 40)
+        {
+            shiftDays(MOOD_CHART_DAYS);
+        }
+    }
+
+    void render(SDL_Renderer *renderer, TextRenderer &glyphs, TTF_Font *font, SDL_Color color, const JournalMood &mood)
+    {
+        glyphs.draw(renderer, font, "<", view.x + 10, view.y, color);
+        glyphs.draw(renderer, font, ">", view.x + view.w - 25, view.y, color);
+        string heading = labels[0] + " - " + labels[MOOD_CHART_DAYS - 1];
+        glyphs.draw(renderer, font, heading, view.x + (view.w - glyphs.width(font, heading)) / 2, view.y, color);
+
+        int top = view.y + 50, height = view.h - 100, middle = top + height / 2;
+        int barWidth = view.w / MOOD_CHART_DAYS;
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+        SDL_RenderDrawLine(renderer, view.x, middle, view.x + barWidth * MOOD_CHART_DAYS, middle);
+        int entries = 0;
+        int64_t sum = 0, hits = 0;
+        for (int i = 0; i < MOOD_CHART_DAYS; i++)
+        {
+            const MoodDay *totals = mood.day(keys[i]);
+            if (totals == NULL)
+            {
+                continue;
+            }
+            entries += totals->entries;
+            sum += totals->sum;
+            hits += totals->hits;
+            // Days written on with no mood words get a stub on the line, so they still show
+            int bar = 2;
+            if (totals->hits > 0)
+            {
+                double average = (double)totals->sum / totals->hits;
+                bar = (int)(min(1.0, fabs(average) / MOOD_CHART_TOP) * (height / 2));
+                bar = max(bar, 2);
+                SDL_SetRenderDrawColor(renderer, average >= 0 ? 100 : 205, average >= 0 ? 205 : 90, average >= 0 ? 139 : 90, 255);
+                SDL_Rect box = {view.x + i * barWidth + 1, average >= 0 ? middle - bar : middle, barWidth - 2, bar};
+                SDL_RenderFillRect(renderer, &box);
+            }
+            else
+            {
+                SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+                SDL_Rect box = {view.x + i * barWidth + 1, middle - bar / 2, barWidth - 2, bar};
+                SDL_RenderFillRect(renderer, &box);
+            }
+        }
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+
+        char summary[64];
+        if (hits > 0)
+        {
+            snprintf(summary, sizeof(summary), "Average %+.1f over %d entries", (double)sum / hits, entries);
+        }
+        else
+        {
+            snprintf(summary, sizeof(summary), "%d entries, no mood words", entries);
+        }
+        glyphs.draw(renderer, font, summary, view.x + (view.w - glyphs.width(font, summary)) / 2, view.y + view.h - 40, color);
+    }
+
+private:
+    SDL_Rect view;
+    int year, month, day;            // the last day shown
+    int keys[MOOD_CHART_DAYS];       // days shown, oldest first, as year * 10000 + month * 100 + day
+    string labels[MOOD_CHART_DAYS];  // the same days as month/day
+
+    // Method to work out the days shown once, when they change, rather than on every frame
+    void refreshDays()
+    {
+        for (int i = 0; i < MOOD_CHART_DAYS; i++)
+        {
+            time_t start = (time_t)journalDayStart(year, month, day - (MOOD_CHART_DAYS - 1 - i));
+            tm local = *localtime(&start);
+            keys[i] = (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+            labels[i] = to_string(local.tm_mon + 1) + "/" + to_string(local.tm_mday);
+        }
+    }
+};
+#endif
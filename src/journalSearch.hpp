@@ -0,0 +1,694 @@
+#ifndef JOURNAL_SEARCH_H
+#define JOURNAL_SEARCH_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include "journalStore.hpp"
+
+// Search index file, version 1. Numbers in the header are little-endian, everything after it is varints.
+//
+//   header (16 bytes): "JSRC", version, term count, FNV-1a checksum of everything after the header
+//   documents: largest id, then for every id from 1 up to it, 0 if it is not a live entry, else its word count + 1
+//   terms: length and bytes of the term, document count, last id, length and bytes of the posting list
+//   posting list: per document in id order, the id minus the previous one, the number of times the term occurs,
+//                 and each position (word number) minus the previous one
+//
+// The file is only a cache: when it is missing or damaged it is rebuilt from the journal, and entries written or
+// deleted since it was saved are caught up when it is opened.
+
+const uint32_t JOURNAL_SEARCH_VERSION = 1;
+const int JOURNAL_SEARCH_HEADER = 16;
+const int JOURNAL_SEARCH_PURGE = 1024; // deleted documents worth rewriting the posting lists for
+const int JOURNAL_SEARCH_RESULTS = 20;
+
+inline void journalPutVarint(vector<uint8_t> &out, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(value);
+}
+inline bool journalGetVarint(const uint8_t *&p, const uint8_t *end, uint32_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7)
+    {
+        uint8_t byte = *p++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        if (byte < 0x80)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// One search result
+struct JournalHit
+{
+    uint32_t id;
+    double score;
+};
+
+// Full-text search over the journal: an inverted index from each word to the entries it occurs in.
+// Posting lists are delta- and varint-encoded byte strings, so adding an entry only appends to the lists of its
+// words. Deleting an entry just marks it dead; dead entries are skipped by queries and dropped from the lists in
+// one pass once enough of them pile up. Terms sit in a sorted map so a prefix query is a range of it.
+//
+// Queries: words must all occur, "quoted words" must occur next to each other in that order, and word* matches
+// every word starting with word. Results are ranked with BM25.
+class JournalSearch
+{
+public:
+    JournalSearch() : liveCount(0), deadCount(0), totalWords(0), lastIndexed(0) {}
+    ~JournalSearch()
+    {
+        close();
+    }
+
+    // Method to load the index saved next to a journal and bring it up to date with the journal's entries
+    bool open(const string &file, JournalStore &journal)
+    {
+        close();
+        path = file;
+        if (!load())
+        {
+            if (journal.size() > 0)
+            {
+                cerr << "Rebuilding journal search index: " << path << endl;
+            }
+            return rebuild(journal);
+        }
+        // Entries deleted since the index was saved are dropped, entries written since are read and added
+        vector<bool> inJournal(words.size(), false);
+        vector<uint32_t> added;
+        bool stale = false;
+        journal.index().forRange(0, journal.size(), [&](const JournalEntry &entry)
+        {
+            if (entry.id < words.size() && words[entry.id] != 0)
+            {
+                inJournal[entry.id] = true;
+            }
+            else if (entry.id <= lastIndexed)
+            {
+                stale = true; // an entry the index should have had; it belongs to another journal
+            }
+            else
+            {
+                added.push_back(entry.id);
+            }
+        });
+        if (stale)
+        {
+            cerr << "Journal search index does not match the journal: " << path << endl;
+            return rebuild(journal);
+        }
+        for (uint32_t id = 1; id < words.size(); id++)
+        {
+            if (words[id] != 0 && !inJournal[id])
+            {
+                remove(id);
+            }
+        }
+        for (uint32_t id : added)
+        {
+            string body;
+            if (journal.read(journal.index().find(id), body))
+            {
+                add(id, body);
+            }
+        }
+        return true;
+    }
+
+    // Method to save the index if it was opened from a file
+    void close()
+    {
+        if (!path.empty())
+        {
+            save();
+        }
+        path.clear();
+        clear();
+    }
+
+    // Method to index a new entry; ids must be added in increasing order
+    void add(uint32_t id, const string &text)
+    {
+        vector<string> tokens;
+        tokenize(text, tokens);
+        // Positions of each distinct word, in order
+        unordered_map<string, vector<uint32_t>> positions;
+        for (uint32_t i = 0; i < tokens.size(); i++)
+        {
+            positions[tokens[i]].push_back(i);
+        }
+        for (const pair<const string, vector<uint32_t>> &word : positions)
+        {
+            Posting &posting = terms[word.first];
+            journalPutVarint(posting.data, id - posting.lastId);
+            journalPutVarint(posting.data, word.second.size());
+            uint32_t previous = 0;
+            for (uint32_t position : word.second)
+            {
+                journalPutVarint(posting.data, position - previous);
+                previous = position;
+            }
+            posting.lastId = id;
+            posting.docs++;
+        }
+        if (words.size() <= id)
+        {
+            words.resize(id + 1, 0);
+        }
+        words[id] = tokens.size() + 1;
+        totalWords += tokens.size();
+        liveCount++;
+        lastIndexed = max(lastIndexed, id);
+    }
+
+    // Method to drop a deleted entry from the results
+    void remove(uint32_t id)
+    {
+        if (id >= words.size() || words[id] == 0)
+        {
+            return;
+        }
+        totalWords -= words[id] - 1;
+        words[id] = 0;
+        liveCount--;
+        deadCount++;
+        if (deadCount >= JOURNAL_SEARCH_PURGE && deadCount * 4 > liveCount)
+        {
+            purge();
+        }
+    }
+
+    // Method to find the entries matching a query, best first; false when the query has no words
+    bool search(const string &query, vector<JournalHit> &hits, int limit = JOURNAL_SEARCH_RESULTS)
+    {
+        hits.clear();
+        vector<Matches> clauses;
+        size_t i = 0;
+        bool any = false;
+        while (i < query.size())
+        {
+            if (isspace((unsigned char)query[i]))
+            {
+                i++;
+                continue;
+            }
+            size_t end;
+            vector<string> tokens;
+            if (query[i] == '"')
+            {
+                end = query.find('"', i + 1);
+                end = end == string::npos ? query.size() : end;
+                tokenize(query.substr(i + 1, end - i - 1), tokens);
+                if (!tokens.empty())
+                {
+                    clauses.push_back(Matches());
+                    phrase(tokens, clauses.back());
+                }
+                i = end + 1;
+            }
+            else
+            {
+                end = i;
+                while (end < query.size() && !isspace((unsigned char)query[end]) && query[end] != '"')
+                {
+                    end++;
+                }
+                string chunk = query.substr(i, end - i);
+                tokenize(chunk, tokens);
+                for (size_t t = 0; t < tokens.size(); t++)
+                {
+                    clauses.push_back(Matches());
+                    if (t + 1 == tokens.size() && chunk[chunk.size() - 1] == '*')
+                    {
+                        prefix(tokens[t], clauses.back());
+                    }
+                    else
+                    {
+                        term(tokens[t], clauses.back());
+                    }
+                }
+                i = end;
+            }
+            any = any || !tokens.empty();
+        }
+        if (!any)
+        {
+            return false;
+        }
+        rank(clauses, hits, limit);
+        return true;
+    }
+
+    // Live entries in the index
+    int size() const
+    {
+        return liveCount;
+    }
+
+private:
+    struct Posting
+    {
+        vector<uint8_t> data;
+        uint32_t lastId;
+        uint32_t docs; // documents in data, dead ones included
+        Posting() : lastId(0), docs(0) {}
+    };
+    // Live documents matching one clause of a query, in id order, with how often the clause occurs in each
+    struct Matches
+    {
+        vector<uint32_t> ids;
+        vector<uint32_t> counts;
+    };
+    // Walks a posting list one document at a time
+    struct Cursor
+    {
+        const uint8_t *p, *end;
+        uint32_t id, count;
+        const uint8_t *positions; // count position deltas start here
+        Cursor(const Posting &posting) : p(posting.data.data()), end(posting.data.data() + posting.data.size()), id(0), count(0), positions(NULL) {}
+        bool next()
+        {
+            uint32_t delta;
+            if (p >= end || !journalGetVarint(p, end, delta) || !journalGetVarint(p, end, count))
+            {
+                return false;
+            }
+            id += delta;
+            positions = p;
+            // Skipping the positions only needs the last byte of each varint, the one below 0x80
+            for (uint32_t i = 0; i < count && p < end; p++)
+            {
+                i += *p < 0x80;
+            }
+            return true;
+        }
+        void readPositions(vector<uint32_t> &out) const
+        {
+            out.clear();
+            const uint8_t *q = positions;
+            uint32_t position = 0, delta;
+            for (uint32_t i = 0; i < count && journalGetVarint(q, end, delta); i++)
+            {
+                position += delta;
+                out.push_back(position);
+            }
+        }
+    };
+
+    string path;
+    map<string, Posting> terms;
+    vector<uint32_t> words; // per id: 0 when not a live entry, else its word count + 1
+    int liveCount, deadCount;
+    uint64_t totalWords;
+    uint32_t lastIndexed; // largest id ever added
+    mutable vector<uint32_t> prefixCounts; // scratch for prefix: per id, 0 outside a query
+
+    void clear()
+    {
+        terms.clear();
+        words.clear();
+        liveCount = deadCount = 0;
+        totalWords = 0;
+        lastIndexed = 0;
+    }
+
+    // Method to split text into lowercase words: runs of ASCII letters and digits and of non-ASCII (UTF-8) bytes
+    static void tokenize(const string &text, vector<string> &tokens)
+    {
+        string word;
+        for (char c : text)
+        {
+            unsigned char byte = c;
+            if (isalnum(byte) || byte >= 0x80)
+            {
+                word += byte < 0x80 ? (char)tolower(byte) : c;
+            }
+            else if (!word.empty())
+            {
+                tokens.push_back(word);
+                word.clear();
+            }
+        }
+        if (!word.empty())
+        {
+            tokens.push_back(word);
+        }
+    }
+
+    bool alive(uint32_t id) const
+    {
+        return id < words.size() && words[id] != 0;
+    }
+
+    void term(const string &word, Matches &out) const
+    {
+        map<string, Posting>::const_iterator it = terms.find(word);
+        if (it == terms.end())
+        {
+            return;
+        }
+        out.ids.reserve(it->second.docs);
+        out.counts.reserve(it->second.docs);
+        Cursor cursor(it->second);
+        while (cursor.next())
+        {
+            if (alive(cursor.id))
+            {
+                out.ids.push_back(cursor.id);
+                out.counts.push_back(cursor.count);
+            }
+        }
+    }
+
+    // Method to merge the lists of every term starting with start, counting into a table indexed by id. The table
+    // is kept between queries and only the slots a query touched are cleared, so a query costs the postings it
+    // matches, not the number of ids.
+    void prefix(const string &start, Matches &out) const
+    {
+        prefixCounts.resize(words.size(), 0);
+        vector<uint32_t> touched; // ids counted, until there are so many that a pass over the table is cheaper
+        size_t dense = prefixCounts.size() / 16;
+        for (map<string, Posting>::const_iterator it = terms.lower_bound(start); it != terms.end() && it->first.compare(0, start.size(), start) == 0; ++it)
+        {
+            Cursor cursor(it->second);
+            while (cursor.next())
+            {
+                if (touched.size() < dense && prefixCounts[cursor.id] == 0)
+                {
+                    touched.push_back(cursor.id);
+                }
+                prefixCounts[cursor.id] += cursor.count;
+            }
+        }
+        if (touched.size() >= dense)
+        {
+            touched.clear();
+            for (uint32_t id = 1; id < prefixCounts.size(); id++)
+            {
+                if (prefixCounts[id] != 0)
+                {
+                    touched.push_back(id);
+                }
+            }
+        }
+        else
+        {
+            sort(touched.begin(), touched.end());
+        }
+        for (uint32_t id : touched)
+        {
+            if (alive(id))
+            {
+                out.ids.push_back(id);
+                out.counts.push_back(prefixCounts[id]);
+            }
+            prefixCounts[id] = 0;
+        }
+    }
+
+    // Method to find the documents where the words occur one after another; the count is how often they do.
+    // The lists are walked side by side, and positions are only decoded for documents holding every word.
+    void phrase(const vector<string> &tokens, Matches &out) const
+    {
+        vector<Cursor> cursors;
+        for (const string &token : tokens)
+        {
+            map<string, Posting>::const_iterator it = terms.find(token);
+            if (it == terms.end())
+            {
+                return;
+            }
+            cursors.push_back(Cursor(it->second));
+        }
+        vector<uint32_t> starts, positions, still;
+        while (cursors[0].next())
+        {
+            uint32_t id = cursors[0].id;
+            if (!alive(id))
+            {
+                continue;
+            }
+            bool all = true;
+            for (size_t k = 1; k < cursors.size() && all; k++)
+            {
+                while (cursors[k].id < id && cursors[k].next())
+                {
+                }
+                all = cursors[k].id == id;
+            }
+            if (!all)
+            {
+                continue;
+            }
+            // Keep the starts s where word k sits at s + k
+            cursors[0].readPositions(starts);
+            for (size_t k = 1; k < cursors.size() && !starts.empty(); k++)
+            {
+                cursors[k].readPositions(positions);
+                still.clear();
+                for (uint32_t start : starts)
+                {
+                    if (binary_search(positions.begin(), positions.end(), start + (uint32_t)k))
+                    {
+                        still.push_back(start);
+                    }
+                }
+                starts.swap(still);
+            }
+            if (!starts.empty())
+            {
+                out.ids.push_back(id);
+                out.counts.push_back(starts.size());
+            }
+        }
+    }
+
+    // Method to keep the documents every clause matches and score them with BM25
+    void rank(vector<Matches> &clauses, vector<JournalHit> &hits, int limit) const
+    {
+        const double k1 = 1.2, b = 0.75;
+        double average = liveCount > 0 ? (double)totalWords / liveCount : 1;
+        // Start from the rarest clause so the intersection shrinks as fast as possible
+        sort(clauses.begin(), clauses.end(), [](const Matches &x, const Matches &y)
+        {
+            return x.ids.size() < y.ids.size();
+        });
+        vector<JournalHit> scored;
+        scored.reserve(clauses[0].ids.size());
+        for (uint32_t id : clauses[0].ids)
+        {
+            scored.push_back({id, 0.0});
+        }
+        for (const Matches &clause : clauses)
+        {
+            double df = clause.ids.size();
+            double idf = log(1 + (liveCount - df + 0.5) / (df + 0.5));
+            size_t kept = 0, j = 0;
+            for (size_t i = 0; i < scored.size(); i++)
+            {
+                while (j < clause.ids.size() && clause.ids[j] < scored[i].id)
+                {
+                    j++;
+                }
+                if (j == clause.ids.size() || clause.ids[j] != scored[i].id)
+                {
+                    continue;
+                }
+                double tf = clause.counts[j];
+                double length = words[scored[i].id] - 1;
+                scored[i].score += idf * tf * (k1 + 1) / (tf + k1 * (1 - b + b * length / average));
+                scored[kept++] = scored[i];
+            }
+            scored.resize(kept);
+        }
+        // Best first; equal scores put the newer entry first
+        size_t top = min(scored.size(), (size_t)limit);
+        partial_sort(scored.begin(), scored.begin() + top, scored.end(), [](const JournalHit &x, const JournalHit &y)
+        {
+            return x.score != y.score ? x.score > y.score : x.id > y.id;
+        });
+        hits.assign(scored.begin(), scored.begin() + top);
+    }
+
+    // Method to rewrite every posting list without the dead documents
+    void purge()
+    {
+        vector<uint32_t> positions;
+        for (map<string, Posting>::iterator it = terms.begin(); it != terms.end();)
+        {
+            Posting kept;
+            Cursor cursor(it->second);
+            while (cursor.next())
+            {
+                if (!alive(cursor.id))
+                {
+                    continue;
+                }
+                journalPutVarint(kept.data, cursor.id - kept.lastId);
+                kept.data.insert(kept.data.end(), cursor.positions - varintSize(cursor.count), cursor.p);
+                kept.lastId = cursor.id;
+                kept.docs++;
+            }
+            if (kept.docs == 0)
+            {
+                it = terms.erase(it);
+            }
+            else
+            {
+                it->second.data.swap(kept.data);
+                it->second.lastId = kept.lastId;
+                it->second.docs = kept.docs;
+                ++it;
+            }
+        }
+        deadCount = 0;
+    }
+
+    static int varintSize(uint32_t value)
+    {
+        int size = 1;
+        for (; value >= 0x80; value >>= 7)
+        {
+            size++;
+        }
+        return size;
+    }
+
+    // Method to index every entry of the journal afresh, reading each body once
+    bool rebuild(JournalStore &journal)
+    {
+        clear();
+        string body;
+        for (int i = 0; i < journal.size(); i++)
+        {
+            if (journal.read(i, body))
+            {
+                add(journal.entry(i).id, body);
+            }
+        }
+        return true;
+    }
+
+    bool load()
+    {
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            return false;
+        }
+        uint64_t length = journalFileSize(file);
+        vector<uint8_t> data(length);
+        rewind(file);
+        bool ok = length >= JOURNAL_SEARCH_HEADER && fread(data.data(), 1, length, file) == length;
+        fclose(file);
+        if (!ok || memcmp(data.data(), "JSRC", 4) != 0 || journalGet(data.data() + 4, 4) != JOURNAL_SEARCH_VERSION ||
+            journalChecksum(data.data() + JOURNAL_SEARCH_HEADER, length - JOURNAL_SEARCH_HEADER) != journalGet(data.data() + 12, 4))
+        {
+            return false;
+        }
+        uint32_t termCount = journalGet(data.data() + 8, 4);
+        const uint8_t *p = data.data() + JOURNAL_SEARCH_HEADER, *end = data.data() + length;
+        uint32_t largest, value;
+        if (!journalGetVarint(p, end, largest) || largest > length)
+        {
+            return false;
+        }
+        words.assign(largest + 1, 0);
+        for (uint32_t id = 1; id <= largest; id++)
+        {
+            if (!journalGetVarint(p, end, value))
+            {
+                clear();
+                return false;
+            }
+            words[id] = value;
+            if (value != 0)
+            {
+                liveCount++;
+                totalWords += value - 1;
+            }
+        }
+        lastIndexed = largest;
+        for (uint32_t t = 0; t < termCount; t++)
+        {
+            uint32_t size, docs, lastId, bytes;
+            if (!journalGetVarint(p, end, size) || size > (uint64_t)(end - p))
+            {
+                clear();
+                return false;
+            }
+            string word((const char *)p, size);
+            p += size;
+            if (!journalGetVarint(p, end, docs) || !journalGetVarint(p, end, lastId) || !journalGetVarint(p, end, bytes) || bytes > (uint64_t)(end - p))
+            {
+                clear();
+                return false;
+            }
+            Posting &posting = terms[word];
+            posting.docs = docs;
+            posting.lastId = lastId;
+            posting.data.assign(p, p + bytes);
+            p += bytes;
+        }
+        if (p != end)
+        {
+            clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool save()
+    {
+        if (deadCount > 0)
+        {
+            purge();
+        }
+        vector<uint8_t> data(JOURNAL_SEARCH_HEADER);
+        uint32_t largest = words.empty() ? 0 : words.size() - 1;
+        journalPutVarint(data, largest);
+        for (uint32_t id = 1; id <= largest; id++)
+        {
+            journalPutVarint(data, id < words.size() ? words[id] : 0);
+        }
+        for (const pair<const string, Posting> &term : terms)
+        {
+            journalPutVarint(data, term.first.size());
+            data.insert(data.end(), term.first.begin(), term.first.end());
+            journalPutVarint(data, term.second.docs);
+            journalPutVarint(data, term.second.lastId);
+            journalPutVarint(data, term.second.data.size());
+            data.insert(data.end(), term.second.data.begin(), term.second.data.end());
+        }
+        memcpy(data.data(), "JSRC", 4);
+        journalPut(data.data() + 4, JOURNAL_SEARCH_VERSION, 4);
+        journalPut(data.data() + 8, terms.size(), 4);
+        journalPut(data.data() + 12, journalChecksum(data.data() + JOURNAL_SEARCH_HEADER, data.size() - JOURNAL_SEARCH_HEADER), 4);
+        string temp = path + ".tmp";
+        FILE *file = fopen(temp.c_str(), "wb");
+        bool ok = file != NULL && fwrite(data.data(), 1, data.size(), file) == data.size() && journalFsync(file);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (!ok || !journalReplace(temp, path))
+        {
+            cerr << "Error writing journal search index: " << path << endl;
+            ::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+};
+#endif
@@ -0,0 +1,702 @@
+#ifndef JOURNAL_STORE_H
+#define JOURNAL_STORE_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "journalIndex.hpp"
+#include "threadPool.hpp"
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+using namespace std;
+
+// Journal files, version 1. All numbers are little-endian.
+//
+//   log header (16 bytes): "JRNL", version, generation, reserved
+//   record (24 byte header + body): body length, FNV-1a checksum of everything after the checksum,
+//                      entry id, flags, time (64 bit seconds)
+//   flags: bit 0 set for a tombstone, which deletes the entry with the same id and has no body
+//
+//   index header (32 bytes): "JIDX", version, entry count, next id, log generation,
+//                      log length the index covers (64 bit), FNV-1a checksum of the entries
+//   index entry (24 bytes): record offset (64 bit), time (64 bit), id, body length
+//
+// The log is only ever appended to. The index lists the live entries up to some length of the log and is
+// rewritten now and then; records appended after that length are replayed when the journal is opened, so
+// opening costs one read of the index plus whatever was written since it was saved. Bodies stay in the log
+// until an entry is viewed.
+// Compaction copies the live records into a new log with the next generation on a worker thread; an index
+// whose generation does not match the log is rebuilt from the log.
+
+const uint32_t JOURNAL_VERSION = 1;
+const int JOURNAL_LOG_HEADER = 16;
+const int JOURNAL_RECORD_HEADER = 24;
+const int JOURNAL_INDEX_HEADER = 32;
+const int JOURNAL_INDEX_ENTRY = 24;
+const uint32_t JOURNAL_TOMBSTONE = 1;
+const int JOURNAL_SYNC_BATCH = 16;               // unsynced records that force an fsync
+const Uint32 JOURNAL_SYNC_MS = 1000;             // longest a record stays unsynced
+const Uint32 JOURNAL_COMPACT_MS = 30000;         // how often tick() considers compacting
+const uint64_t JOURNAL_COMPACT_MIN = 64 * 1024;  // deleted bytes worth compacting for
+
+// Function to compute the 32 bit FNV-1a hash used for record and index checksums
+inline uint32_t journalChecksum(const uint8_t *data, size_t length, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+inline uint64_t journalGet(const uint8_t *p, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+inline void journalPut(uint8_t *p, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        p[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+// Large-file seeking, flushing to disk and truncation differ between the C runtimes
+inline bool journalSeek(FILE *file, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+inline uint64_t journalFileSize(FILE *file)
+{
+#ifdef _WIN32
+    _fseeki64(file, 0, SEEK_END);
+    return _ftelli64(file);
+#else
+    fseeko(file, 0, SEEK_END);
+    return ftello(file);
+#endif
+}
+inline bool journalFsync(FILE *file)
+{
+    if (fflush(file) != 0)
+    {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+inline bool journalTruncate(FILE *file, uint64_t length)
+{
+    fflush(file);
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), (__int64)length) == 0;
+#else
+    return ftruncate(fileno(file), (off_t)length) == 0;
+#endif
+}
+// Method to move a finished file over the one it replaces in a single step
+inline bool journalReplace(const string &from, const string &to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// A journal kept on disk as an append-only record log plus an index of the live entries.
+// Entries are numbered from 0 in the order they were written; only their index data is held in memory.
+class JournalStore
+{
+public:
+    JournalStore() : log(NULL), logEnd(0), generation(0), nextId(1), liveBytes(0), pending(0), batching(false), pendingSince(0),
+                     lastCompact(0), compacting(false), compactEnd(0), compactDone(false), compactOk(false), compactor(1)
+    {
+        lock = SDL_CreateMutex();
+    }
+    ~JournalStore()
+    {
+        close();
+        compactor.wait();
+        SDL_DestroyMutex(lock);
+    }
+
+    // Method to open a journal, creating it when the log does not exist yet
+    bool open(const string &logFile, const string &indexFile)
+    {
+        close();
+        logPath = logFile;
+        indexPath = indexFile;
+        log = fopen(logPath.c_str(), "r+b");
+        if (log == NULL)
+        {
+            log = fopen(logPath.c_str(), "w+b");
+            generation = 1;
+            if (log == NULL || !writeLogHeader(log, generation) || !journalFsync(log))
+            {
+                cerr << "Error creating journal: " << logPath << endl;
+                abandon();
+                return false;
+            }
+        }
+        uint8_t header[JOURNAL_LOG_HEADER];
+        rewind(log);
+        if (fread(header, 1, JOURNAL_LOG_HEADER, log) != JOURNAL_LOG_HEADER || memcmp(header, "JRNL", 4) != 0 || journalGet(header + 4, 4) != JOURNAL_VERSION)
+        {
+            cerr << "Invalid journal: " << logPath << endl;
+            abandon();
+            return false;
+        }
+        generation = journalGet(header + 8, 4);
+        logEnd = journalFileSize(log);
+        uint64_t covered = JOURNAL_LOG_HEADER;
+        if (!loadIndex(covered))
+        {
+            if (logEnd > JOURNAL_LOG_HEADER)
+            {
+                cerr << "Rebuilding journal index from " << logPath << endl;
+            }
+            entries.clear();
+            nextId = 1;
+            covered = JOURNAL_LOG_HEADER;
+        }
+        liveBytes = 0;
+        entries.forRange(0, entries.size(), [this](const JournalEntry &entry)
+        {
+            liveBytes += JOURNAL_RECORD_HEADER + entry.length;
+        });
+        // Records written after the index was saved
+        if (covered < logEnd)
+        {
+            replay(covered);
+            saveIndex();
+        }
+        lastCompact = SDL_GetTicks();
+        return true;
+    }
+
+    // Method to flush everything and save the index; the store can be opened again afterwards
+    void close()
+    {
+        if (compacting)
+        {
+            compactor.wait();
+            finishCompaction();
+        }
+        if (log != NULL)
+        {
+            sync();
+            saveIndex();
+            fclose(log);
+        }
+        log = NULL;
+        entries.clear();
+        logEnd = 0;
+        liveBytes = 0;
+        pending = 0;
+    }
+
+    bool isOpen() const
+    {
+        return log != NULL;
+    }
+
+    int size() const
+    {
+        return entries.size();
+    }
+
+    const JournalEntry &entry(int i) const
+    {
+        return entries[i];
+    }
+
+    // The id the next appended entry will get; every id written so far, live or deleted, is below it
+    uint32_t nextEntryId() const
+    {
+        return nextId;
+    }
+
+    // The live entries, for walking a range of them in order
+    const JournalIndex &index() const
+    {
+        return entries;
+    }
+
+    // Method to add an entry at the end; it is on disk after the next sync
+    bool append(const string &body)
+    {
+        return append(body, (int64_t)time(0));
+    }
+
+    // Method to add an entry written at some other time, such as one imported from another journal
+    bool append(const string &body, int64_t written)
+    {
+        JournalEntry entry = {logEnd, written, nextId, (uint32_t)body.size()};
+        if (!writeRecord(entry, 0, body))
+        {
+            return false;
+        }
+        entries.push_back(entry);
+        liveBytes += JOURNAL_RECORD_HEADER + entry.length;
+        nextId++;
+        return true;
+    }
+
+    // Method to read the body of entry i from the log, checking its checksum
+    bool read(int i, string &body)
+    {
+        if (log == NULL || i < 0 || i >= size())
+        {
+            return false;
+        }
+        const JournalEntry &entry = entries[i];
+        vector<uint8_t> record(JOURNAL_RECORD_HEADER + entry.length);
+        if (!journalSeek(log, entry.offset) || fread(record.data(), 1, record.size(), log) != record.size() || !checkRecord(record.data(), record.size()) || journalGet(record.data() + 8, 4) != entry.id)
+        {
+            cerr << "Journal entry " << entry.id << " is damaged" << endl;
+            return false;
+        }
+        body.assign((const char *)record.data() + JOURNAL_RECORD_HEADER, entry.length);
+        return true;
+    }
+
+    // Method to delete entry i by appending a tombstone; the record itself goes at the next compaction
+    bool remove(int i)
+    {
+        if (log == NULL || i < 0 || i >= size())
+        {
+            return false;
+        }
+        JournalEntry tombstone = {logEnd, (int64_t)time(0), entries[i].id, 0};
+        if (!writeRecord(tombstone, JOURNAL_TOMBSTONE, string()))
+        {
+            return false;
+        }
+        liveBytes -= JOURNAL_RECORD_HEADER + entries[i].length;
+        entries.erase(i);
+        return true;
+    }
+
+    // Method to start writing a large batch of records: they are only fsynced when sync() is called,
+    // not every JOURNAL_SYNC_BATCH records, so a bulk import costs one fsync per batch it chooses
+    void beginBatch()
+    {
+        batching = true;
+    }
+
+    // Method to end a batch: syncs what is left of it and saves the index, so reopening replays none of it
+    bool endBatch()
+    {
+        batching = false;
+        return saveIndex();
+    }
+
+    // Method to fsync the records written since the last sync
+    bool sync()
+    {
+        if (log == NULL || pending == 0)
+        {
+            return true;
+        }
+        pending = 0;
+        if (!journalFsync(log))
+        {
+            cerr << "Error syncing journal: " << logPath << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Method to call once per frame: syncs records that have waited long enough, and starts or finishes compaction
+    void tick()
+    {
+        if (log == NULL)
+        {
+            return;
+        }
+        Uint32 now = SDL_GetTicks();
+        if (pending > 0 && now - pendingSince >= JOURNAL_SYNC_MS)
+        {
+            sync();
+        }
+        if (compacting)
+        {
+            SDL_LockMutex(lock);
+            bool done = compactDone;
+            SDL_UnlockMutex(lock);
+            if (done)
+            {
+                finishCompaction();
+            }
+        }
+        else if (now - lastCompact >= JOURNAL_COMPACT_MS)
+        {
+            lastCompact = now;
+            uint64_t dead = logEnd - JOURNAL_LOG_HEADER - liveBytes;
+            if (dead >= JOURNAL_COMPACT_MIN && dead > liveBytes)
+            {
+                startCompaction();
+            }
+        }
+    }
+
+    // Method to write the index for the whole log, through a temporary file so a crash leaves the old one intact
+    bool saveIndex()
+    {
+        if (log == NULL)
+        {
+            return false;
+        }
+        // The index must never cover records that are not on disk yet
+        sync();
+        vector<uint8_t> data(JOURNAL_INDEX_HEADER + entries.size() * JOURNAL_INDEX_ENTRY);
+        uint8_t *p = data.data() + JOURNAL_INDEX_HEADER;
+        entries.forRange(0, entries.size(), [&p](const JournalEntry &entry)
+        {
+            journalPut(p, entry.offset, 8);
+            journalPut(p + 8, (uint64_t)entry.time, 8);
+            journalPut(p + 16, entry.id, 4);
+            journalPut(p + 20, entry.length, 4);
+            p += JOURNAL_INDEX_ENTRY;
+        });
+        memcpy(data.data(), "JIDX", 4);
+        journalPut(data.data() + 4, JOURNAL_VERSION, 4);
+        journalPut(data.data() + 8, entries.size(), 4);
+        journalPut(data.data() + 12, nextId, 4);
+        journalPut(data.data() + 16, generation, 4);
+        journalPut(data.data() + 20, logEnd, 8);
+        journalPut(data.data() + 28, journalChecksum(data.data() + JOURNAL_INDEX_HEADER, data.size() - JOURNAL_INDEX_HEADER), 4);
+        string temp = indexPath + ".tmp";
+        FILE *file = fopen(temp.c_str(), "wb");
+        bool ok = file != NULL && fwrite(data.data(), 1, data.size(), file) == data.size() && journalFsync(file);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (!ok || !journalReplace(temp, indexPath))
+        {
+            cerr << "Error writing journal index: " << indexPath << endl;
+            ::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    FILE *log;
+    string logPath, indexPath;
+    JournalIndex entries; // live entries in log order, so both offsets and ids ascend
+    uint64_t logEnd;
+    uint32_t generation;
+    uint32_t nextId;
+    uint64_t liveBytes;  // bytes of the log taken by live records
+    int pending;         // records written since the last fsync
+    bool batching;       // a bulk write is under way and chooses when to sync
+    Uint32 pendingSince; // when the oldest of them was written
+    Uint32 lastCompact;
+
+    // Compaction state; the worker only touches the compact* members, and only until it sets compactDone
+    SDL_mutex *lock;
+    bool compacting;
+    vector<JournalEntry> snapshot; // live entries when compaction started
+    vector<uint64_t> newOffsets; // where each snapshot record went in the new log
+    uint64_t snapshotEnd;        // log length when compaction started
+    uint64_t compactEnd;         // length of the new log
+    bool compactDone, compactOk;
+    ThreadPool compactor; // declared last so its thread stops before the members it uses are destroyed
+
+    JournalStore(const JournalStore &);
+    JournalStore &operator=(const JournalStore &);
+
+    // Method to let go of a log that could not be opened, without writing an index for it
+    void abandon()
+    {
+        if (log != NULL)
+        {
+            fclose(log);
+        }
+        log = NULL;
+    }
+
+    static bool writeLogHeader(FILE *file, uint32_t logGeneration)
+    {
+        uint8_t header[JOURNAL_LOG_HEADER] = {'J', 'R', 'N', 'L'};
+        journalPut(header + 4, JOURNAL_VERSION, 4);
+        journalPut(header + 8, logGeneration, 4);
+        return fwrite(header, 1, JOURNAL_LOG_HEADER, file) == JOURNAL_LOG_HEADER;
+    }
+
+    static bool checkRecord(const uint8_t *record, size_t length)
+    {
+        return length >= JOURNAL_RECORD_HEADER && journalGet(record, 4) == length - JOURNAL_RECORD_HEADER &&
+               journalChecksum(record + 8, length - 8) == journalGet(record + 4, 4);
+    }
+
+    bool writeRecord(const JournalEntry &entry, uint32_t flags, const string &body)
+    {
+        if (log == NULL)
+        {
+            return false;
+        }
+        vector<uint8_t> record(JOURNAL_RECORD_HEADER + body.size());
+        journalPut(record.data(), body.size(), 4);
+        journalPut(record.data() + 8, entry.id, 4);
+        journalPut(record.data() + 12, flags, 4);
+        journalPut(record.data() + 16, (uint64_t)entry.time, 8);
+        memcpy(record.data() + JOURNAL_RECORD_HEADER, body.data(), body.size());
+        journalPut(record.data() + 4, journalChecksum(record.data() + 8, record.size() - 8), 4);
+        if (!journalSeek(log, logEnd) || fwrite(record.data(), 1, record.size(), log) != record.size())
+        {
+            cerr << "Error writing journal: " << logPath << endl;
+            // Cut off whatever part of the record made it, so the next record starts at a record boundary
+            journalTruncate(log, logEnd);
+            return false;
+        }
+        logEnd += record.size();
+        if (pending++ == 0)
+        {
+            pendingSince = SDL_GetTicks();
+        }
+        if (pending >= JOURNAL_SYNC_BATCH && !batching)
+        {
+            sync();
+        }
+        return true;
+    }
+
+    // Method to load the index file; false when it is missing, damaged or belongs to another log generation
+    bool loadIndex(uint64_t &covered)
+    {
+        FILE *file = fopen(indexPath.c_str(), "rb");
+        if (file == NULL)
+        {
+            return false;
+        }
+        uint64_t length = journalFileSize(file);
+        vector<uint8_t> data(length);
+        rewind(file);
+        bool ok = length >= JOURNAL_INDEX_HEADER && fread(data.data(), 1, length, file) == length;
+        fclose(file);
+        if (!ok || memcmp(data.data(), "JIDX", 4) != 0 || journalGet(data.data() + 4, 4) != JOURNAL_VERSION || journalGet(data.data() + 16, 4) != generation)
+        {
+            return false;
+        }
+        uint32_t count = journalGet(data.data() + 8, 4);
+        covered = journalGet(data.data() + 20, 8);
+        if (length != JOURNAL_INDEX_HEADER + (uint64_t)count * JOURNAL_INDEX_ENTRY || covered < JOURNAL_LOG_HEADER || covered > logEnd ||
+            journalChecksum(data.data() + JOURNAL_INDEX_HEADER, length - JOURNAL_INDEX_HEADER) != journalGet(data.data() + 28, 4))
+        {
+            return false;
+        }
+        nextId = journalGet(data.data() + 12, 4);
+        const uint8_t *p = data.data() + JOURNAL_INDEX_HEADER;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            JournalEntry entry;
+            entry.offset = journalGet(p, 8);
+            entry.time = (int64_t)journalGet(p + 8, 8);
+            entry.id = journalGet(p + 16, 4);
+            entry.length = journalGet(p + 20, 4);
+            if (entry.offset < JOURNAL_LOG_HEADER || entry.offset + JOURNAL_RECORD_HEADER + entry.length > covered || entry.id >= nextId)
+            {
+                return false;
+            }
+            entries.push_back(entry);
+            p += JOURNAL_INDEX_ENTRY;
+        }
+        return true;
+    }
+
+    // Method to apply the records from offset to the end of the log. A damaged record can only be the tail of
+    // a write that never finished, so the log is cut off there.
+    void replay(uint64_t offset)
+    {
+        uint8_t header[JOURNAL_RECORD_HEADER];
+        vector<uint8_t> record;
+        while (offset < logEnd)
+        {
+            bool ok = logEnd - offset >= JOURNAL_RECORD_HEADER && journalSeek(log, offset) && fread(header, 1, JOURNAL_RECORD_HEADER, log) == JOURNAL_RECORD_HEADER;
+            uint64_t length = ok ? journalGet(header, 4) : 0;
+            ok = ok && length <= logEnd - offset - JOURNAL_RECORD_HEADER;
+            if (ok)
+            {
+                record.assign(header, header + JOURNAL_RECORD_HEADER);
+                record.resize(JOURNAL_RECORD_HEADER + length);
+                ok = fread(record.data() + JOURNAL_RECORD_HEADER, 1, length, log) == length && checkRecord(record.data(), record.size());
+            }
+            if (!ok)
+            {
+                cerr << "Dropping " << logEnd - offset << " damaged bytes at the end of " << logPath << endl;
+                journalTruncate(log, offset);
+                logEnd = offset;
+                return;
+            }
+            uint32_t id = journalGet(header + 8, 4);
+            if (journalGet(header + 12, 4) & JOURNAL_TOMBSTONE)
+            {
+                int i = entries.find(id);
+                if (i >= 0)
+                {
+                    liveBytes -= JOURNAL_RECORD_HEADER + entries[i].length;
+                    entries.erase(i);
+                }
+            }
+            else
+            {
+                JournalEntry entry = {offset, (int64_t)journalGet(header + 16, 8), id, (uint32_t)length};
+                entries.push_back(entry);
+                liveBytes += JOURNAL_RECORD_HEADER + length;
+                nextId = max(nextId, id + 1);
+            }
+            offset += JOURNAL_RECORD_HEADER + length;
+        }
+    }
+
+    void startCompaction()
+    {
+        sync();
+        compacting = true;
+        compactDone = compactOk = false;
+        snapshot.clear();
+        snapshot.reserve(entries.size());
+        entries.forRange(0, entries.size(), [this](const JournalEntry &entry)
+        {
+            snapshot.push_back(entry);
+        });
+        snapshotEnd = logEnd;
+        compactor.submit([this]()
+        {
+            bool ok = copyLive();
+            SDL_LockMutex(lock);
+            compactOk = ok;
+            compactDone = true;
+            SDL_UnlockMutex(lock);
+        });
+    }
+
+    // Runs on the compactor thread: copies the snapshot's records into the next generation of the log.
+    // It reads the log through its own handle and never past snapshotEnd, which the game thread no longer writes to.
+    bool copyLive()
+    {
+        string temp = logPath + ".tmp";
+        FILE *source = fopen(logPath.c_str(), "rb");
+        FILE *target = fopen(temp.c_str(), "wb");
+        bool ok = source != NULL && target != NULL && writeLogHeader(target, generation + 1);
+        compactEnd = JOURNAL_LOG_HEADER;
+        newOffsets.clear();
+        vector<uint8_t> record;
+        for (size_t i = 0; ok && i < snapshot.size(); i++)
+        {
+            record.resize(JOURNAL_RECORD_HEADER + snapshot[i].length);
+            ok = journalSeek(source, snapshot[i].offset) && fread(record.data(), 1, record.size(), source) == record.size() &&
+                 checkRecord(record.data(), record.size()) && fwrite(record.data(), 1, record.size(), target) == record.size();
+            newOffsets.push_back(compactEnd);
+            compactEnd += record.size();
+        }
+        ok = ok && journalFsync(target);
+        if (source != NULL)
+        {
+            fclose(source);
+        }
+        if (target != NULL)
+        {
+            fclose(target);
+        }
+        return ok;
+    }
+
+    // Method to switch over to the compacted log on the game thread: records written while the worker ran are
+    // copied after the compacted ones, then the new log replaces the old one and the index is saved for it
+    void finishCompaction()
+    {
+        compacting = false;
+        string temp = logPath + ".tmp";
+        FILE *target = compactOk ? fopen(temp.c_str(), "r+b") : NULL;
+        bool ok = target != NULL && sync() && journalSeek(target, compactEnd);
+        vector<uint8_t> chunk(64 * 1024);
+        for (uint64_t offset = snapshotEnd; ok && offset < logEnd; offset += chunk.size())
+        {
+            size_t bytes = min((uint64_t)chunk.size(), logEnd - offset);
+            ok = journalSeek(log, offset) && fread(chunk.data(), 1, bytes, log) == bytes && fwrite(chunk.data(), 1, bytes, target) == bytes;
+        }
+        ok = ok && journalFsync(target);
+        if (target != NULL)
+        {
+            fclose(target);
+        }
+        if (!ok)
+        {
+            cerr << "Journal compaction failed; keeping " << logPath << endl;
+            ::remove(temp.c_str());
+            snapshot.clear();
+            return;
+        }
+        fclose(log);
+        log = NULL;
+        if (!journalReplace(temp, logPath))
+        {
+            cerr << "Error replacing journal: " << logPath << endl;
+            ::remove(temp.c_str());
+        }
+        else
+        {
+            // The entries and the snapshot are both in log order, so one pass matches them up
+            size_t j = 0;
+            entries.forRange(0, entries.size(), [this, &j](JournalEntry &entry)
+            {
+                if (entry.offset >= snapshotEnd)
+                {
+                    entry.offset = entry.offset - snapshotEnd + compactEnd;
+                    return;
+                }
+                while (snapshot[j].offset != entry.offset)
+                {
+                    j++;
+                }
+                entry.offset = newOffsets[j];
+            });
+            entries.pack();
+            logEnd = logEnd - snapshotEnd + compactEnd;
+            generation++;
+        }
+        snapshot.clear();
+        newOffsets.clear();
+        log = fopen(logPath.c_str(), "r+b");
+        if (log == NULL)
+        {
+            cerr << "Error reopening journal: " << logPath << endl;
+            entries.clear();
+            return;
+        }
+        saveIndex();
+    }
+};
+#endif
@@ -0,0 +1,442 @@
+#ifndef JOURNAL_TAGS_H
+#define JOURNAL_TAGS_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cctype>
+#include <map>
+#include <string>
+#include <vector>
+#include "journalStore.hpp"
+#include "roaringBitmap.hpp"
+using namespace std;
+
+// Tag index file, version 1. Numbers in the header are little-endian.
+//
+//   header (20 bytes): "JTAG", version, tag count, largest id indexed, FNV-1a checksum of everything after it
+//   the ids of all live entries as a bitmap, then per tag: its length (1 byte), its bytes and its entries' bitmap
+//
+// Bitmaps are written as RoaringBitmap::serialize lays them out. Like the other index files it is only a cache:
+// entries written or deleted since it was saved are caught up when it is opened, and it is rebuilt from the
+// journal when it is missing or damaged.
+
+const uint32_t JOURNAL_TAGS_VERSION = 1;
+const int JOURNAL_TAGS_HEADER = 20;
+const int JOURNAL_TAG_MAX = 64; // longest tag kept, in bytes
+
+// Entries' #tags, with a bitmap of entry ids for every tag. A filter such as "#work AND NOT #sleep" is a handful
+// of bitmap operations, each a pass over at most a few 8 KB containers however many entries there are.
+//
+// Filters: #tags joined by AND, OR and NOT (in any case) and parentheses, where NOT binds tightest, then AND,
+// then OR, and two tags side by side mean AND.
+class JournalTags
+{
+public:
+    JournalTags() : lastIndexed(0) {}
+    ~JournalTags()
+    {
+        close();
+    }
+
+    // Method to load the index saved next to a journal and bring it up to date with the journal's entries
+    bool open(const string &file, JournalStore &journal)
+    {
+        close();
+        path = file;
+        RoaringBitmap inJournal;
+        vector<int> added; // entry numbers whose bodies have to be read
+        bool stale = false;
+        bool loaded = load();
+        int position = 0;
+        journal.index().forRange(0, journal.size(), [&](const JournalEntry &entry)
+        {
+            inJournal.add(entry.id);
+            if (entry.id > lastIndexed)
+            {
+                added.push_back(position);
+            }
+            else if (!live.contains(entry.id))
+            {
+                stale = true; // an entry the index should have had; it belongs to another journal
+            }
+            position++;
+        });
+        if (!loaded || stale)
+        {
+            if (stale)
+            {
+                cerr << "Journal tag index does not match the journal: " << path << endl;
+            }
+            else if (journal.size() > 0)
+            {
+                cerr << "Rebuilding journal tag index: " << path << endl;
+            }
+            clear();
+            return rebuild(journal);
+        }
+        // Entries deleted since the index was saved leave every tag in one difference per tag
+        RoaringBitmap deleted = live;
+        deleted.subtract(inJournal);
+        if (!deleted.empty())
+        {
+            live.subtract(deleted);
+            for (map<string, RoaringBitmap>::iterator tag = tags.begin(); tag != tags.end();)
+            {
+                tag->second.subtract(deleted);
+                tag = tag->second.empty() ? tags.erase(tag) : ++tag;
+            }
+        }
+        string body;
+        for (int i : added)
+        {
+            if (journal.read(i, body))
+            {
+                add(journal.entry(i).id, body);
+            }
+        }
+        return true;
+    }
+
+    // Method to save the index if it was opened from a file
+    void close()
+    {
+        if (!path.empty())
+        {
+            save();
+        }
+        path.clear();
+        clear();
+    }
+
+    // Method to index a new entry's tags
+    void add(uint32_t id, const string &text)
+    {
+        vector<string> found;
+        parse(text, found);
+        for (const string &tag : found)
+        {
+            tags[tag].add(id);
+        }
+        live.add(id);
+        lastIndexed = max(lastIndexed, id);
+    }
+
+    void remove(uint32_t id)
+    {
+        if (!live.contains(id))
+        {
+            return;
+        }
+        live.remove(id);
+        for (map<string, RoaringBitmap>::iterator tag = tags.begin(); tag != tags.end();)
+        {
+            tag->second.remove(id);
+            tag = tag->second.empty() ? tags.erase(tag) : ++tag;
+        }
+    }
+
+    // Method to run a filter into a bitmap of entry ids; false, with no ids, when it is not a valid filter
+    bool filter(const string &query, RoaringBitmap &result) const
+    {
+        result.clear();
+        vector<string> tokens;
+        split(query, tokens);
+        size_t next = 0;
+        if (tokens.empty() || !parseOr(tokens, next, result) || next != tokens.size())
+        {
+            result.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Method to run a filter into ids, in increasing (oldest first) order
+    bool filter(const string &query, vector<uint32_t> &ids) const
+    {
+        RoaringBitmap result;
+        bool ok = filter(query, result);
+        result.values(ids);
+        return ok;
+    }
+
+    // Method to list every tag with the number of entries carrying it
+    void names(vector<pair<string, uint32_t>> &out) const
+    {
+        out.clear();
+        for (const pair<const string, RoaringBitmap> &tag : tags)
+        {
+            out.push_back(make_pair(tag.first, tag.second.size()));
+        }
+    }
+
+    // Method to find the #tags in text, lowercase and without their #, each once.
+    // A tag is a # at the start of a word followed by a letter, then letters, digits, _ and -; non-ASCII (UTF-8)
+    // bytes count as letters. "#1" and "C#" are not tags.
+    static void parse(const string &text, vector<string> &found)
+    {
+        found.clear();
+        for (size_t i = 0; i < text.size(); i++)
+        {
+            if (text[i] != '#' || (i > 0 && tagByte(text[i - 1])) || i + 1 >= text.size() || !tagByte(text[i + 1]) || isdigit((unsigned char)text[i + 1]))
+            {
+                continue;
+            }
+            size_t end = i + 1;
+            while (end < text.size() && tagByte(text[end]))
+            {
+                end++;
+            }
+            string tag = text.substr(i + 1, min(end - i - 1, (size_t)JOURNAL_TAG_MAX));
+            for (char &c : tag)
+            {
+                c = (unsigned char)c < 0x80 ? tolower((unsigned char)c) : c;
+            }
+            if (find(found.begin(), found.end(), tag) == found.end())
+            {
+                found.push_back(tag);
+            }
+            i = end - 1;
+        }
+    }
+
+private:
+    string path;
+    map<string, RoaringBitmap> tags; // entries by tag; a tag goes when its last entry does
+    RoaringBitmap live;              // every live entry, which NOT is taken against
+    uint32_t lastIndexed;            // largest id ever indexed
+
+    JournalTags(const JournalTags &);
+    JournalTags &operator=(const JournalTags &);
+
+    static bool tagByte(char c)
+    {
+        unsigned char byte = c;
+        return isalnum(byte) || byte == '_' || byte == '-' || byte >= 0x80;
+    }
+
+    void clear()
+    {
+        tags.clear();
+        live.clear();
+        lastIndexed = 0;
+    }
+
+    // Method to split a filter into #tags, parentheses and words
+    static void split(const string &query, vector<string> &tokens)
+    {
+        string token;
+        for (char c : query)
+        {
+            if (c == ' ' || c == '\t' || c == '(' || c == ')')
+            {
+                if (!token.empty())
+                {
+                    tokens.push_back(token);
+                    token.clear();
+                }
+                if (c == '(' || c == ')')
+                {
+                    tokens.push_back(string(1, c));
+                }
+            }
+            else
+            {
+                token += (unsigned char)c < 0x80 ? tolower((unsigned char)c) : c;
+            }
+        }
+        if (!token.empty())
+        {
+            tokens.push_back(token);
+        }
+    }
+
+    // or := and ("or" and)*
+    bool parseOr(const vector<string> &tokens, size_t &next, RoaringBitmap &result) const
+    {
+        if (!parseAnd(tokens, next, result))
+        {
+            return false;
+        }
+        while (next < tokens.size() && tokens[next] == "or")
+        {
+            RoaringBitmap right;
+            next++;
+            if (!parseAnd(tokens, next, right))
+            {
+                return false;
+            }
+            result.unite(right);
+        }
+        return true;
+    }
+
+    // and := not (["and"] not)*
+    bool parseAnd(const vector<string> &tokens, size_t &next, RoaringBitmap &result) const
+    {
+        if (!parseNot(tokens, next, result))
+        {
+            return false;
+        }
+        while (next < tokens.size() && tokens[next] != "or" && tokens[next] != ")")
+        {
+            if (tokens[next] == "and")
+            {
+                next++;
+            }
+            // AND NOT is a difference, so the complement of the right side is never built
+            bool negate = false;
+            while (next < tokens.size() && tokens[next] == "not")
+            {
+                negate = !negate;
+                next++;
+            }
+            RoaringBitmap right;
+            if (!parseNot(tokens, next, right))
+            {
+                return false;
+            }
+            if (negate)
+            {
+                result.subtract(right);
+            }
+            else
+            {
+                result.intersect(right);
+            }
+        }
+        return true;
+    }
+
+    // not := "not" not | "(" or ")" | #tag
+    bool parseNot(const vector<string> &tokens, size_t &next, RoaringBitmap &result) const
+    {
+        if (next >= tokens.size())
+        {
+            return false;
+        }
+        const string &token = tokens[next++];
+        if (token == "not")
+        {
+            RoaringBitmap inner;
+            if (!parseNot(tokens, next, inner))
+            {
+                return false;
+            }
+            result = live;
+            result.subtract(inner);
+            return true;
+        }
+        if (token == "(")
+        {
+            if (!parseOr(tokens, next, result) || next >= tokens.size() || tokens[next] != ")")
+            {
+                return false;
+            }
+            next++;
+            return true;
+        }
+        if (token.size() < 2 || token[0] != '#')
+        {
+            return false;
+        }
+        map<string, RoaringBitmap>::const_iterator found = tags.find(token.substr(1, JOURNAL_TAG_MAX));
+        result.clear();
+        if (found != tags.end())
+        {
+            result = found->second;
+        }
+        return true;
+    }
+
+    // Method to index every entry of the journal afresh, reading each body once
+    bool rebuild(JournalStore &journal)
+    {
+        string body;
+        for (int i = 0; i < journal.size(); i++)
+        {
+            if (journal.read(i, body))
+            {
+                add(journal.entry(i).id, body);
+            }
+        }
+        return true;
+    }
+
+    bool load()
+    {
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            return false;
+        }
+        uint64_t length = journalFileSize(file);
+        vector<uint8_t> data(length);
+        rewind(file);
+        bool ok = length >= JOURNAL_TAGS_HEADER && fread(data.data(), 1, length, file) == length;
+        fclose(file);
+        if (!ok || memcmp(data.data(), "JTAG", 4) != 0 || journalGet(data.data() + 4, 4) != JOURNAL_TAGS_VERSION ||
+            journalChecksum(data.data() + JOURNAL_TAGS_HEADER, length - JOURNAL_TAGS_HEADER) != journalGet(data.data() + 16, 4))
+        {
+            return false;
+        }
+        uint32_t tagCount = journalGet(data.data() + 8, 4);
+        const uint8_t *p = data.data() + JOURNAL_TAGS_HEADER, *end = data.data() + length;
+        if (!live.deserialize(p, end))
+        {
+            clear();
+            return false;
+        }
+        for (uint32_t t = 0; t < tagCount; t++)
+        {
+            if (p >= end || *p > end - p - 1)
+            {
+                clear();
+                return false;
+            }
+            string tag((const char *)p + 1, *p);
+            p += 1 + *p;
+            if (!tags[tag].deserialize(p, end))
+            {
+                clear();
+                return false;
+            }
+        }
+        if (p != end)
+        {
+            clear();
+            return false;
+        }
+        lastIndexed = journalGet(data.data() + 12, 4);
+        return true;
+    }
+
+    bool save()
+    {
+        vector<uint8_t> data(JOURNAL_TAGS_HEADER);
+        live.serialize(data);
+        for (const pair<const string, RoaringBitmap> &tag : tags)
+        {
+            data.push_back(tag.first.size());
+            data.insert(data.end(), tag.first.begin(), tag.first.end());
+            tag.second.serialize(data);
+        }
+        memcpy(data.data(), "JTAG", 4);
+        journalPut(data.data() + 4, JOURNAL_TAGS_VERSION, 4);
+        journalPut(data.data() + 8, tags.size(), 4);
+        journalPut(data.data() + 12, lastIndexed, 4);
+        journalPut(data.data() + 16, journalChecksum(data.data() + JOURNAL_TAGS_HEADER, data.size() - JOURNAL_TAGS_HEADER), 4);
+        string temp = path + ".tmp";
+        FILE *file = fopen(temp.c_str(), "wb");
+        bool ok = file != NULL && fwrite(data.data(), 1, data.size(), file) == data.size() && journalFsync(file);
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (!ok || !journalReplace(temp, path))
+        {
+            cerr << "Error writing journal tag index: " << path << endl;
+            ::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+};
+#endif
@@ -0,0 +1,240 @@
+#ifndef JOURNAL_TIMELINE_H
+#define JOURNAL_TIMELINE_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <vector>
+#include "journalIndex.hpp"
+using namespace std;
+
+const uint32_t JOURNAL_REMOVED = 0xFFFFFFFF; // id left in the base run where an entry was deleted
+const int JOURNAL_RECENT_MIN = 1024;         // entries the recent run may hold before it is merged, at least
+
+// Start of a local calendar day as an epoch time; day may run past the month's end and month past December
+inline int64_t journalDayStart(int year, int month, int day)
+{
+    tm date = {};
+    date.tm_year = year - 1900;
+    date.tm_mon = month - 1;
+    date.tm_mday = day;
+    date.tm_isdst = -1;
+    return (int64_t)mktime(&date);
+}
+
+// Finds the local day of a time, as year * 10000 + month * 100 + day.
+// Entries come in runs written on the same day, so the last day looked up is remembered.
+class JournalDayFinder
+{
+public:
+    JournalDayFinder() : start(1), end(0), day(0) {}
+
+    int dayOf(int64_t time)
+    {
+        if (time >= start && time < end)
+        {
+            return day;
+        }
+        time_t when = (time_t)time;
+        tm local = *localtime(&when);
+        day = (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
+        start = journalDayStart(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+        end = journalDayStart(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday + 1);
+        return day;
+    }
+
+private:
+    int64_t start, end; // the day remembered is [start, end)
+    int day;
+};
+
+// The journal's entries ordered by when they were written, with a count of entries for every local day.
+// Entries sit in two sorted runs: a large base run and a small recent one that new entries go into, which is merged
+// into the base once it grows past a sixty-fourth of it. A delete in the base run only leaves a tombstone, cleared
+// at the next merge. A time range is two binary searches plus a walk over the entries in it, O(log n + k), and a
+// month's calendar reads at most 31 per-day counts without touching the entries.
+class JournalTimeline
+{
+public:
+    JournalTimeline() : removed(0) {}
+
+    // Method to index every entry of a journal, replacing what was indexed before
+    void build(const JournalIndex &entries)
+    {
+        base.clear();
+        recent.clear();
+        days.clear();
+        removed = 0;
+        base.reserve(entries.size());
+        bool sorted = true;
+        entries.forRange(0, entries.size(), [&](const JournalEntry &entry)
+        {
+            TimeKey key = {entry.time, entry.id};
+            sorted = sorted && (base.empty() || base.back().time <= key.time);
+            base.push_back(key);
+            days[dayOf(entry.time)]++;
+        });
+        // Entries are written in time order, so the log is sorted unless the clock was turned back
+        if (!sorted)
+        {
+            stable_sort(base.begin(), base.end(), earlier);
+        }
+    }
+
+    void add(int64_t time, uint32_t id)
+    {
+        TimeKey key = {time, id};
+        recent.insert(upper_bound(recent.begin(), recent.end(), key, earlier), key);
+        days[dayOf(time)]++;
+        if ((int)recent.size() > max(JOURNAL_RECENT_MIN, (int)base.size() / 64))
+        {
+            merge();
+        }
+    }
+
+    void remove(int64_t time, uint32_t id)
+    {
+        if (!take(recent, time, id, false) && !take(base, time, id, true))
+        {
+            return;
+        }
+        map<int, int>::iterator day = days.find(dayOf(time));
+        if (day != days.end() && --day->second == 0)
+        {
+            days.erase(day);
+        }
+        if (removed > (int)base.size() / 4)
+        {
+            merge();
+        }
+    }
+
+    // Method to collect the ids of entries written in [from, to), oldest first
+    void range(int64_t from, int64_t to, vector<uint32_t> &ids) const
+    {
+        ids.clear();
+        TimeKey low = {from, 0};
+        vector<TimeKey>::const_iterator a = lower_bound(base.begin(), base.end(), low, earlier);
+        vector<TimeKey>::const_iterator b = lower_bound(recent.begin(), recent.end(), low, earlier);
+        while (true)
+        {
+            bool moreBase = a != base.end() && a->time < to, moreRecent = b != recent.end() && b->time < to;
+            if (!moreBase && !moreRecent)
+            {
+                break;
+            }
+            if (moreBase && (!moreRecent || a->time <= b->time))
+            {
+                if (a->id != JOURNAL_REMOVED)
+                {
+                    ids.push_back(a->id);
+                }
+                ++a;
+            }
+            else
+            {
+                ids.push_back(b->id);
+                ++b;
+            }
+        }
+    }
+
+    // Method to fill counts[d] with the entries written on day d of a month (counts[0] is unused)
+    void monthCounts(int year, int month, int counts[32]) const
+    {
+        fill(counts, counts + 32, 0);
+        int first = year * 10000 + month * 100;
+        for (map<int, int>::const_iterator day = days.lower_bound(first); day != days.end() && day->first <= first + 31; ++day)
+        {
+            counts[day->first - first] = day->second;
+        }
+    }
+
+    // Entries written on the local days [first, last], both as year * 10000 + month * 100 + day
+    int countDays(int first, int last) const
+    {
+        int total = 0;
+        for (map<int, int>::const_iterator day = days.lower_bound(first); day != days.end() && day->first <= last; ++day)
+        {
+            total += day->second;
+        }
+        return total;
+    }
+
+    int size() const
+    {
+        return base.size() - removed + recent.size();
+    }
+
+private:
+    struct TimeKey
+    {
+        int64_t time;
+        uint32_t id;
+    };
+    vector<TimeKey> base, recent; // each sorted by time; entries written at the same time keep their order
+    int removed;                  // tombstones in base
+    map<int, int> days;           // entries per local day, by year * 10000 + month * 100 + day
+    JournalDayFinder calendarDays;
+
+    static bool earlier(const TimeKey &a, const TimeKey &b)
+    {
+        return a.time < b.time;
+    }
+
+    int dayOf(int64_t time)
+    {
+        return calendarDays.dayOf(time);
+    }
+
+    // Method to take an entry out of a run, or only mark it removed; returns whether it was there
+    bool take(vector<TimeKey> &run, int64_t time, uint32_t id, bool mark)
+    {
+        TimeKey key = {time, id};
+        for (vector<TimeKey>::iterator it = lower_bound(run.begin(), run.end(), key, earlier); it != run.end() && it->time == time; ++it)
+        {
+            if (it->id == id)
+            {
+                if (mark)
+                {
+                    it->id = JOURNAL_REMOVED;
+                    removed++;
+                }
+                else
+                {
+                    run.erase(it);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Method to fold the recent run into the base one, dropping tombstones
+    void merge()
+    {
+        vector<TimeKey> merged;
+        merged.reserve(base.size() - removed + recent.size());
+        vector<TimeKey>::iterator a = base.begin(), b = recent.begin();
+        while (a != base.end() || b != recent.end())
+        {
+            if (b == recent.end() || (a != base.end() && a->time <= b->time))
+            {
+                if (a->id != JOURNAL_REMOVED)
+                {
+                    merged.push_back(*a);
+                }
+                ++a;
+            }
+            else
+            {
+                merged.push_back(*b++);
+            }
+        }
+        base.swap(merged);
+        recent.clear();
+        removed = 0;
+    }
+};
+#endif
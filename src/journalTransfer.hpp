@@ -0,0 +1,699 @@
+#ifndef JOURNAL_TRANSFER_H
+#define JOURNAL_TRANSFER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "journalStore.hpp"
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+using namespace std;
+
+// Journal import and export formats:
+//
+//   JSON Lines: one entry per line, {"id":12,"time":1767225600,"date":"2026-01-01T00:00:00","text":"..."}.
+//               On import "text" may also be called "body" or "content"; "time" (epoch seconds) wins over "date"
+//               (local time, "YYYY-MM-DD" optionally followed by "THH:MM" or "THH:MM:SS"); other fields are ignored.
+//   Markdown:   one file per entry at YYYY/MM/YYYY-MM-DD_HHMMSS_<id>.md under a folder, starting with a front matter
+//               block ("---", then id, date and time lines, then "---") and a blank line before the text. On import
+//               files without front matter take their date from a name starting with YYYY-MM-DD.
+//
+// Both are streamed one entry at a time through a fixed buffer, so memory does not grow with the journal.
+// Imports are written as one store batch with an fsync every JOURNAL_IMPORT_BATCH entries.
+
+const int JOURNAL_TRANSFER_BUFFER = 1 << 16;
+const int JOURNAL_IMPORT_BATCH = 4096;
+
+// Folder creation and listing differ between the C runtimes
+inline bool journalMakeFolder(const string &path)
+{
+#ifdef _WIN32
+    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+// Method to list a folder's entries, sorted by name, split into subfolders and files
+inline bool journalListFolder(const string &path, vector<string> &folders, vector<string> &files)
+{
+    folders.clear();
+    files.clear();
+#ifdef _WIN32
+    WIN32_FIND_DATAA found;
+    HANDLE search = FindFirstFileA((path + "\\*").c_str(), &found);
+    if (search == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    do
+    {
+        string name = found.cFileName;
+        if (name != "." && name != "..")
+        {
+            ((found.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? folders : files).push_back(name);
+        }
+    } while (FindNextFileA(search, &found));
+    FindClose(search);
+#else
+    DIR *folder = opendir(path.c_str());
+    if (folder == NULL)
+    {
+        return false;
+    }
+    while (dirent *item = readdir(folder))
+    {
+        string name = item->d_name;
+        struct stat info;
+        if (name != "." && name != ".." && stat((path + "/" + name).c_str(), &info) == 0)
+        {
+            (S_ISDIR(info.st_mode) ? folders : files).push_back(name);
+        }
+    }
+    closedir(folder);
+#endif
+    sort(folders.begin(), folders.end());
+    sort(files.begin(), files.end());
+    return true;
+}
+
+// Reads a file a line at a time through a fixed buffer; a line costs only its own length in memory
+class JournalLineReader
+{
+public:
+    JournalLineReader(FILE *f) : file(f), buffer(JOURNAL_TRANSFER_BUFFER), start(0), end(0) {}
+
+    // Method to read the next line without its line break; false at the end of the file
+    bool next(string &line)
+    {
+        line.clear();
+        while (true)
+        {
+            if (start == end)
+            {
+                end = fread(buffer.data(), 1, buffer.size(), file);
+                start = 0;
+                if (end == 0)
+                {
+                    return !line.empty();
+                }
+            }
+            char *found = (char *)memchr(buffer.data() + start, '\n', end - start);
+            size_t stop = found != NULL ? found - buffer.data() : end;
+            line.append(buffer.data() + start, stop - start);
+            start = stop;
+            if (found != NULL)
+            {
+                start++;
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+                return true;
+            }
+        }
+    }
+
+private:
+    FILE *file;
+    vector<char> buffer;
+    size_t start, end; // unread bytes are buffer[start, end)
+};
+
+// Moves entries between a journal and JSON Lines or Markdown files.
+// Indexes kept beside the journal take in imported entries when they are next opened.
+class JournalTransfer
+{
+public:
+    JournalTransfer(JournalStore &store) : journal(store), count(0), skipped(0), bytes(0) {}
+
+    // Entries written or read by the last call, lines or files that could not be imported, and the bytes moved
+    int entries() const
+    {
+        return count;
+    }
+    int rejected() const
+    {
+        return skipped;
+    }
+    uint64_t transferred() const
+    {
+        return bytes;
+    }
+
+    bool exportJsonLines(const string &path)
+    {
+        reset();
+        FILE *file = fopen(path.c_str(), "wb");
+        if (file == NULL)
+        {
+            cerr << "Could not create " << path << endl;
+            return false;
+        }
+        setvbuf(file, NULL, _IOFBF, JOURNAL_TRANSFER_BUFFER);
+        string body, line;
+        bool ok = true;
+        for (int i = 0; i < journal.size() && ok; i++)
+        {
+            const JournalEntry &entry = journal.entry(i);
+            ok = journal.read(i, body);
+            line = "{\"id\":" + to_string(entry.id) + ",\"time\":" + to_string(entry.time) + ",\"date\":\"" + formatDate(entry.time) + "\",\"text\":\"";
+            appendEscaped(line, body);
+            line += "\"}\n";
+            ok = ok && fwrite(line.data(), 1, line.size(), file) == line.size();
+            bytes += line.size();
+            count++;
+        }
+        ok = fclose(file) == 0 && ok;
+        if (!ok)
+        {
+            cerr << "Error exporting the journal to " << path << endl;
+        }
+        return ok;
+    }
+
+    bool importJsonLines(const string &path)
+    {
+        reset();
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            cerr << "Could not open " << path << endl;
+            return false;
+        }
+        JournalLineReader reader(file);
+        string line, text;
+        bool ok = true;
+        journal.beginBatch();
+        for (int number = 1; ok && reader.next(line); number++)
+        {
+            bytes += line.size() + 1;
+            int64_t written;
+            if (line.find_first_not_of(" \t") == string::npos)
+            {
+                continue;
+            }
+            if (!parseJsonLine(line, written, text))
+            {
+                cerr << path << ":" << number << ": not a journal entry" << endl;
+                skipped++;
+                continue;
+            }
+            ok = add(text, written);
+        }
+        fclose(file);
+        return journal.endBatch() && ok;
+    }
+
+    bool exportMarkdown(const string &folder)
+    {
+        reset();
+        if (!journalMakeFolder(folder))
+        {
+            cerr << "Could not create " << folder << endl;
+            return false;
+        }
+        string body, madeMonth;
+        for (int i = 0; i < journal.size(); i++)
+        {
+            const JournalEntry &entry = journal.entry(i);
+            if (!journal.read(i, body))
+            {
+                return false;
+            }
+            string date = formatDate(entry.time);
+            string year = folder + "/" + date.substr(0, 4), month = year + "/" + date.substr(5, 2);
+            // Imports can append older entries, so months may come round again; folders are made whenever the month
+            // differs from the last entry's, and making one that already exists is harmless
+            if (month != madeMonth && !(journalMakeFolder(year) && journalMakeFolder(month)))
+            {
+                cerr << "Could not create " << month << endl;
+                return false;
+            }
+            madeMonth = month;
+            string name = month + "/" + date.substr(0, 10) + "_" + date.substr(11, 2) + date.substr(14, 2) + date.substr(17, 2) + "_" + to_string(entry.id) + ".md";
+            string text = "---\nid: " + to_string(entry.id) + "\ndate: " + date + "\ntime: " + to_string(entry.time) + "\n---\n\n" + body;
+            FILE *file = fopen(name.c_str(), "wb");
+            bool ok = file != NULL && fwrite(text.data(), 1, text.size(), file) == text.size();
+            if (file == NULL || fclose(file) != 0 || !ok)
+            {
+                cerr << "Error writing " << name << endl;
+                return false;
+            }
+            bytes += text.size();
+            count++;
+        }
+        return true;
+    }
+
+    // Method to import every .md file under a folder, walking it in name order so dated names import oldest first
+    bool importMarkdown(const string &folder)
+    {
+        reset();
+        journal.beginBatch();
+        bool ok = importFolder(folder);
+        return journal.endBatch() && ok;
+    }
+
+private:
+    JournalStore &journal;
+    int count, skipped;
+    uint64_t bytes;
+
+    JournalTransfer(const JournalTransfer &);
+    JournalTransfer &operator=(const JournalTransfer &);
+
+    void reset()
+    {
+        count = skipped = 0;
+        bytes = 0;
+    }
+
+    // Method to append one imported entry, syncing at the end of each batch
+    bool add(const string &text, int64_t written)
+    {
+        if (!journal.append(text, written))
+        {
+            return false;
+        }
+        if (++count % JOURNAL_IMPORT_BATCH == 0)
+        {
+            return journal.sync();
+        }
+        return true;
+    }
+
+    bool importFolder(const string &folder)
+    {
+        vector<string> folders, files;
+        if (!journalListFolder(folder, folders, files))
+        {
+            cerr << "Could not read " << folder << endl;
+            return false;
+        }
+        string text;
+        for (const string &name : files)
+        {
+            if (name.size() < 3 || name.compare(name.size() - 3, 3, ".md") != 0)
+            {
+                continue;
+            }
+            string path = folder + "/" + name;
+            int64_t written;
+            if (!readFile(path, text))
+            {
+                skipped++;
+                continue;
+            }
+            bytes += text.size();
+            parseMarkdown(name, text, written);
+            if (!add(text, written))
+            {
+                return false;
+            }
+        }
+        for (const string &name : folders)
+        {
+            if (!importFolder(folder + "/" + name))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool readFile(const string &path, string &text)
+    {
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == NULL)
+        {
+            cerr << "Could not open " << path << endl;
+            return false;
+        }
+        text.clear();
+        char chunk[4096];
+        size_t got;
+        while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            text.append(chunk, got);
+        }
+        fclose(file);
+        return true;
+    }
+
+    // Method to strip the front matter off a Markdown entry, taking its time from it or else from the file name
+    static void parseMarkdown(const string &name, string &text, int64_t &written)
+    {
+        written = -1;
+        if (text.compare(0, 4, "---\n") == 0)
+        {
+            size_t close = text.find("\n---\n", 3);
+            if (close != string::npos)
+            {
+                string date;
+                size_t line = 4;
+                while (line <= close)
+                {
+                    size_t stop = text.find('\n', line);
+                    string field = text.substr(line, stop - line);
+                    if (field.compare(0, 5, "time:") == 0)
+                    {
+                        written = atoll(field.c_str() + 5);
+                    }
+                    else if (field.compare(0, 5, "date:") == 0)
+                    {
+                        date = field.substr(field.find_first_not_of(' ', 5));
+                    }
+                    line = stop + 1;
+                }
+                if (written < 0)
+                {
+                    written = parseDate(date);
+                }
+                size_t body = close + 5;
+                if (text.compare(body, 1, "\n") == 0)
+                {
+                    body++;
+                }
+                text.erase(0, body);
+            }
+        }
+        if (written < 0)
+        {
+            written = parseDate(name);
+        }
+        if (written < 0)
+        {
+            written = (int64_t)time(0);
+        }
+    }
+
+    // Local time of "YYYY-MM-DD", optionally followed by "THH:MM[:SS]" or " HH:MM[:SS]"; -1 when it is not a date
+    static int64_t parseDate(const string &date)
+    {
+        tm when = {};
+        if (sscanf(date.c_str(), "%4d-%2d-%2d", &when.tm_year, &when.tm_mon, &when.tm_mday) != 3)
+        {
+            return -1;
+        }
+        if (date.size() > 10 && (date[10] == 'T' || date[10] == ' '))
+        {
+            sscanf(date.c_str() + 11, "%2d:%2d:%2d", &when.tm_hour, &when.tm_min, &when.tm_sec);
+        }
+        when.tm_year -= 1900;
+        when.tm_mon -= 1;
+        when.tm_isdst = -1;
+        return (int64_t)mktime(&when);
+    }
+
+    static string formatDate(int64_t written)
+    {
+        time_t when = (time_t)written;
+        char buffer[32];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", localtime(&when));
+        return buffer;
+    }
+
+    static void appendEscaped(string &out, const string &text)
+    {
+        for (unsigned char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                }
+                else
+                {
+                    out += (char)c;
+                }
+            }
+        }
+    }
+
+    // Method to read one JSON object, keeping its text and time; false when the line is not such an object
+    static bool parseJsonLine(const string &line, int64_t &written, string &text)
+    {
+        size_t i = skipSpace(line, 0);
+        if (i >= line.size() || line[i] != '{')
+        {
+            return false;
+        }
+        written = -1;
+        bool hasText = false;
+        string key, value, date;
+        i = skipSpace(line, i + 1);
+        while (i < line.size() && line[i] != '}')
+        {
+            if (!parseString(line, i, key))
+            {
+                return false;
+            }
+            i = skipSpace(line, i);
+            if (i >= line.size() || line[i] != ':')
+            {
+                return false;
+            }
+            i = skipSpace(line, i + 1);
+            if (i < line.size() && line[i] == '"')
+            {
+                if (!parseString(line, i, value))
+                {
+                    return false;
+                }
+                if (key == "text" || key == "body" || key == "content")
+                {
+                    text.swap(value);
+                    hasText = true;
+                }
+                else if (key == "date")
+                {
+                    date = value;
+                }
+            }
+            else
+            {
+                size_t start = i;
+                if (!skipValue(line, i))
+                {
+                    return false;
+                }
+                if (key == "time")
+                {
+                    written = atoll(line.c_str() + start);
+                }
+            }
+            i = skipSpace(line, i);
+            if (i < line.size() && line[i] == ',')
+            {
+                i = skipSpace(line, i + 1);
+            }
+        }
+        if (i >= line.size() || !hasText)
+        {
+            return false;
+        }
+        if (written < 0)
+        {
+            written = parseDate(date);
+        }
+        if (written < 0)
+        {
+            written = (int64_t)time(0);
+        }
+        return true;
+    }
+
+    static size_t skipSpace(const string &line, size_t i)
+    {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t'))
+        {
+            i++;
+        }
+        return i;
+    }
+
+    // Method to decode the JSON string starting at line[i], leaving i just after its closing quote
+    static bool parseString(const string &line, size_t &i, string &out)
+    {
+        if (i >= line.size() || line[i] != '"')
+        {
+            return false;
+        }
+        out.clear();
+        for (i++; i < line.size(); i++)
+        {
+            char c = line[i];
+            if (c == '"')
+            {
+                i++;
+                return true;
+            }
+            if (c != '\\')
+            {
+                out += c;
+                continue;
+            }
+            if (++i >= line.size())
+            {
+                return false;
+            }
+            switch (line[i])
+            {
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'u':
+            {
+                uint32_t point;
+                if (!parseHex(line, i, point))
+                {
+                    return false;
+                }
+                // A UTF-16 surrogate pair spells a code point above the basic plane
+                uint32_t low;
+                if (point >= 0xD800 && point < 0xDC00 && line.compare(i + 1, 2, "\\u") == 0)
+                {
+                    size_t after = i + 2;
+                    if (parseHex(line, after, low) && low >= 0xDC00 && low < 0xE000)
+                    {
+                        point = 0x10000 + ((point - 0xD800) << 10) + (low - 0xDC00);
+                        i = after;
+                    }
+                }
+                appendUtf8(out, point);
+                break;
+            }
+            default:
+                out += line[i]; // \" \\ and \/
+            }
+        }
+        return false;
+    }
+
+    // Method to read the four hex digits after line[i] (the 'u' of an escape), leaving i on the last of them
+    static bool parseHex(const string &line, size_t &i, uint32_t &point)
+    {
+        if (i + 4 >= line.size())
+        {
+            return false;
+        }
+        point = 0;
+        for (int k = 1; k <= 4; k++)
+        {
+            char c = line[i + k];
+            int digit = c >= '0' && c <= '9' ? c - '0' : (c >= 'a' && c <= 'f' ? c - 'a' + 10 : (c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1));
+            if (digit < 0)
+            {
+                return false;
+            }
+            point = point * 16 + digit;
+        }
+        i += 4;
+        return true;
+    }
+
+    static void appendUtf8(string &out, uint32_t point)
+    {
+        if (point < 0x80)
+        {
+            out += (char)point;
+        }
+        else if (point < 0x800)
+        {
+            out += (char)(0xC0 | (point >> 6));
+            out += (char)(0x80 | (point & 0x3F));
+        }
+        else if (point < 0x10000)
+        {
+            out += (char)(0xE0 | (point >> 12));
+            out += (char)(0x80 | ((point >> 6) & 0x3F));
+            out += (char)(0x80 | (point & 0x3F));
+        }
+        else
+        {
+            out += (char)(0xF0 | (point >> 18));
+            out += (char)(0x80 | ((point >> 12) & 0x3F));
+            out += (char)(0x80 | ((point >> 6) & 0x3F));
+            out += (char)(0x80 | (point & 0x3F));
+        }
+    }
+
+    // Method to step over a JSON number, literal, object or array, leaving i just after it
+    static bool skipValue(const string &line, size_t &i)
+    {
+        int depth = 0;
+        string ignored;
+        while (i < line.size())
+        {
+            char c = line[i];
+            if (c == '"')
+            {
+                if (!parseString(line, i, ignored))
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[')
+            {
+                depth++;
+            }
+            else if (c == '}' || c == ']')
+            {
+                if (depth == 0)
+                {
+                    return true;
+                }
+                depth--;
+            }
+            else if (c == ',' && depth == 0)
+            {
+                return true;
+            }
+            i++;
+        }
+        return depth == 0;
+    }
+};
+#endif
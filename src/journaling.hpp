@@ -1,103 +1,65 @@
 #include <sstream>
 #include "baseClass.hpp"
+#include "journalCalendar.hpp"
+#include "journalDraft.hpp"
+#include "journalList.hpp"
+#include "journalMoodChart.hpp"
+#include "journalSearch.hpp"
+#include "journalTags.hpp"
+#include "textEditor.hpp"
+#include "textLayout.hpp"
 
 const int maxLineWidth = 45;
+const int WRAP_PIXELS = 330; // width journal text wraps at, about the 25 characters it used to be cut at
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 700;
-class LTexture
-{
-public:
-    LTexture()
-    {
-        mTexture = NULL;
-        mWidth = 0;
-        mHeight = 0;
-    }
-    ~LTexture()
-    {
-        free();
-    }
-    bool loadFromRenderedText(SDL_Renderer *_renderer, TTF_Font *Font, string textureText, SDL_Color textColor)
-    {
-        free();
-        SDL_Surface *textSurface = TTF_RenderText_Solid(Font, textureText.c_str(), textColor);
-        if (textSurface != NULL)
-        {
-            mTexture = SDL_CreateTextureFromSurface(_renderer, textSurface);
-            if (mTexture == NULL)
-            {
-                cout << "Unable to create texture from rendered text! SDL Error: " << SDL_GetError() << endl;
-            }
-            else
-            {
-                mWidth = textSurface->w;
-                mHeight = textSurface->h;
-            }
-
-            SDL_FreeSurface(textSurface);
-        }
-        else
-        {
-            cout << "Unable to render text surface! SDL_ttf Error: " << TTF_GetError() << endl;
-        }
-
-        return mTexture != NULL;
-    }
-
-    void free()
-    {
-        if (mTexture != NULL)
-        {
-            SDL_DestroyTexture(mTexture);
-            mTexture = NULL;
-            mWidth = 0;
-            mHeight = 0;
-        }
-    }
-    void render(SDL_Renderer *_renderer, int x, int y, SDL_Rect *clip = NULL, double angle = 0.0, SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE)
-    {
-        SDL_Rect renderQuad = {x, y, mWidth, mHeight};
-        if (clip != NULL)
-        {
-            renderQuad.w = clip->w;
-            renderQuad.h = clip->h;
-        }
-
-        SDL_RenderCopyEx(_renderer, mTexture, clip, &renderQuad, angle, center, flip);
-    }
-    int getWidth()
-    {
-        return mWidth;
-    }
-    int getHeight()
-    {
-        return mHeight;
-    }
-
-private:
-    SDL_Texture *mTexture;
-    int mWidth;
-    int mHeight;
-};
 //child class of main stress reliever class
 class Journaling : public StressReliever
 {
 private:
     SDL_Texture *background1, *background2, *buttonNext, *buttonViewNotes, *buttonBack, *buttonDeleteNotes;
     SDL_Color textColor;
-    LTexture gPromptTextTexture, gInputTextTexture;
-    SDL_Rect buttonBackRect, buttonNextRect, buttonViewNotesRect, buttonDeleteRect;
-    bool quit, viewNotesClicked, deleteNotesClicked, switchToNextScreen, renderText;
+    SDL_Rect buttonBackRect, buttonNextRect, buttonViewNotesRect, buttonDeleteRect, buttonSearchRect, buttonCalendarRect, buttonMoodRect;
+    bool quit, viewNotesClicked, deleteNotesClicked, searchClicked, calendarClicked, moodClicked, switchToNextScreen, renderText;
     string inputText, selectedEntryData;
     int selectedEntryNumber;
-    DoublyLinkedList DoublyLinkedList;
+    JournalStore journal; // entries live on disk; only their index is kept in memory
+    JournalSearch search; // declared after the journal so it is saved before the journal closes
+    JournalTags tags;     // entries by #tag, for filters typed into the search box
+    vector<int> searchResults; // entry numbers matching the search box, best first
+    JournalTimeline timeline;  // entries by the time they were written, with counts per day
+    JournalCalendar calendar;
+    vector<int> calendarResults; // entry numbers written on the day picked in the calendar
+    string calendarSummary;
+    JournalMood mood; // mood scores of the entries, totalled per day; saved before the journal closes too
+    JournalMoodChart moodChart;
+    JournalList notesList;
+    TextLayout layout; // line breaks of the text drawn on screen, kept while the text stays the same
+    TextEditor editor; // the entry being written on the second screen
+    JournalDraft draft; // the entry being written, autosaved in the background until it is saved to the journal
 
 public:
-    Journaling() : StressReliever("Journaling", 800, 700), selectedEntryNumber(-1)
+    Journaling() : StressReliever("Journaling", 800, 700), selectedEntryNumber(-1), calendar({440, 100, 7 * CALENDAR_CELL_WIDTH, 8 * CALENDAR_CELL_HEIGHT}), moodChart({430, 100, SCREEN_WIDTH - 450, 400}), notesList({430, 100, SCREEN_WIDTH - 430, SCREEN_HEIGHT - 100}, 70), layout(textRenderer), editor(textRenderer, {240, 80, WRAP_PIXELS + 10, 400}), draft("textFiles/journal.draft")
     {
-        quit = viewNotesClicked = deleteNotesClicked = switchToNextScreen = renderText = false;
+        quit = viewNotesClicked = deleteNotesClicked = searchClicked = calendarClicked = moodClicked = switchToNextScreen = renderText = false;
         inputText = selectedEntryData = "";
         initialize();
+        if (!journal.open("textFiles/journal.log", "textFiles/journal.idx"))
+        {
+            cerr << "Journal entries will not be saved" << endl;
+        }
+        search.open("textFiles/journal.search", journal);
+        tags.open("textFiles/journal.tags", journal);
+        timeline.build(journal.index());
+        mood.open("textFiles/journal.mood", journal);
+        // An entry left unsaved when the window closed is opened again where it was being written
+        string unsaved;
+        if (draft.load(unsaved))
+        {
+            editor.setText(unsaved);
+            draft.markSaved(editor.version());
+            switchToNextScreen = true;
+        }
     }
     ~Journaling()
     {
@@ -122,11 +84,26 @@ public:
                 renderTexture(buttonNext, renderer, buttonNextRect.x, buttonNextRect.y, buttonNextRect.w, buttonNextRect.h);
                 renderTexture(buttonViewNotes, renderer, buttonViewNotesRect.x, buttonViewNotesRect.y, buttonViewNotesRect.w, buttonViewNotesRect.h);
                 renderTexture(buttonDeleteNotes, renderer, buttonDeleteRect.x, buttonDeleteRect.y, buttonDeleteRect.w, buttonDeleteRect.h);
+                renderFramedButton(buttonSearchRect, "Search");
+                renderFramedButton(buttonCalendarRect, "Calendar");
+                renderFramedButton(buttonMoodRect, "Mood");
                 RenderText(selectedEntryData, 450, 140, true); 
                 if (viewNotesClicked)
                 {
                     ViewNotesClicked();
                 }
+                else if (searchClicked)
+                {
+                    SearchClicked();
+                }
+                else if (calendarClicked)
+                {
+                    CalendarClicked();
+                }
+                else if (moodClicked)
+                {
+                    moodChart.render(renderer, textRenderer, font, textColor, mood);
+                }
                 else if (deleteNotesClicked)
                 {
                     DeleteNotesClicked();
@@ -134,13 +111,27 @@ public:
                 else
                 {
                     // Display notes on the side
-                    renderNotesList(renderer, textColor, true);
+                    renderNotesList(renderer, textColor);
                 }
             }
 
             SDL_RenderPresent(renderer);
+            journal.tick();
+            draft.edited(editor.version());
+            if (draft.due())
+            {
+                draft.save(editor.text());
+            }
         }
 
+        journal.sync();
+        // Typing since the last autosave goes to the draft before the window closes
+        draft.edited(editor.version());
+        if (draft.unsaved())
+        {
+            draft.save(editor.text());
+        }
+        draft.flush();
         SDL_StopTextInput();
     }
 private:
@@ -158,6 +149,9 @@ private:
         buttonNextRect = {100, 100, 200, 50};
         buttonViewNotesRect = {100, 200, 200, 50};
         buttonDeleteRect = {100, 300, 200, 50};
+        buttonSearchRect = {100, 400, 200, 50};
+        buttonCalendarRect = {100, 500, 200, 50};
+        buttonMoodRect = {100, 600, 200, 50};
 
         font = TTF_OpenFont("fonts/Oswald-Bold.ttf", 28);
         if (!font)
@@ -165,13 +159,7 @@ private:
             cerr << "Failed to load font. SDL_ttf Error: " << TTF_GetError() << endl;
             return;
         }
-
-        if (!gPromptTextTexture.loadFromRenderedText(renderer, font, "Happy Journaling!", textColor) ||
-            !gInputTextTexture.loadFromRenderedText(renderer, font, " ", textColor))
-        {
-            cerr << "Failed to render text!" << endl;
-            return;
-        }
+        editor.setFont(font);
     }
     void handleMouseButtonDown()
     {
@@ -182,7 +170,20 @@ private:
         if (switchToNextScreen && SDL_PointInRect(&mousePoint, &buttonBackRect))
         {
 
-            DoublyLinkedList.addNode(inputText);
+            string entry = editor.text();
+            if (!journal.append(entry))
+            {
+                selectedEntryData = "Could not save the note!";
+            }
+            else
+            {
+                draft.discard(editor.version());
+                const JournalEntry &saved = journal.entry(journal.size() - 1);
+                search.add(saved.id, entry);
+                tags.add(saved.id, entry);
+                timeline.add(saved.time, saved.id);
+                mood.add(saved.time, saved.id, entry);
+            }
             // Switch back to the previous screen after saving the note
             switchToNextScreen = false;
             viewNotesClicked = false;
@@ -192,15 +193,23 @@ private:
         else if (!switchToNextScreen && SDL_PointInRect(&mousePoint, &buttonNextRect))
         {
             // Switch to the next screen
-            inputText = "";
+            editor.clear();
             switchToNextScreen = true;
         }
+        //clicking in the entry moves its cursor; shift-click selects up to the click
+        else if (switchToNextScreen && editor.contains(mousePoint.x, mousePoint.y))
+        {
+            editor.click(mousePoint.x, mousePoint.y, SDL_GetModState() & KMOD_SHIFT);
+        }
         //when its on view notes button
         else if (!switchToNextScreen && SDL_PointInRect(&mousePoint, &buttonViewNotesRect))
         {
             inputText = "";
             selectedEntryNumber = -1;
             deleteNotesClicked = false;
+            searchClicked = false;
+            calendarClicked = false;
+            moodClicked = false;
             viewNotesClicked = true;
             selectedEntryData = "";  
             RenderText(selectedEntryData, 450, 140, true); 
@@ -210,11 +219,63 @@ private:
         {
             inputText = "";
             selectedEntryNumber = -1;
+            moodClicked = false;
             deleteNotesClicked = true;
             viewNotesClicked = false;
+            searchClicked = false;
+            calendarClicked = false;
             selectedEntryData = "";  
             RenderText(selectedEntryData, 450, 140, true); 
         }
+        //when its on search button
+        else if (!switchToNextScreen && SDL_PointInRect(&mousePoint, &buttonSearchRect))
+        {
+            inputText = "";
+            selectedEntryNumber = -1;
+            deleteNotesClicked = false;
+            viewNotesClicked = false;
+            calendarClicked = false;
+            moodClicked = false;
+            searchClicked = true;
+            selectedEntryData = "";
+            searchResults.clear();
+        }
+        //when its on calendar button
+        else if (!switchToNextScreen && SDL_PointInRect(&mousePoint, &buttonCalendarRect))
+        {
+            inputText = "";
+            selectedEntryNumber = -1;
+            deleteNotesClicked = false;
+            viewNotesClicked = false;
+            searchClicked = false;
+            moodClicked = false;
+            calendarClicked = true;
+            selectedEntryData = "";
+            refreshCalendar();
+        }
+        //when its on mood button
+        else if (!switchToNextScreen && SDL_PointInRect(&mousePoint, &buttonMoodRect))
+        {
+            inputText = "";
+            selectedEntryNumber = -1;
+            deleteNotesClicked = false;
+            viewNotesClicked = false;
+            searchClicked = false;
+            calendarClicked = false;
+            moodClicked = true;
+            selectedEntryData = "";
+        }
+        //clicking in the mood chart's arrows moves it a month of days
+        else if (!switchToNextScreen && moodClicked && moodChart.contains(mousePoint.x, mousePoint.y))
+        {
+            moodChart.click(mousePoint.x, mousePoint.y);
+        }
+        //clicking in the calendar changes the month or picks a day
+        else if (!switchToNextScreen && calendarClicked && calendar.contains(mousePoint.x, mousePoint.y))
+        {
+            calendar.click(mousePoint.x, mousePoint.y);
+            refreshCalendar();
+        }
     }
     void handleEvents()
     {
@@ -236,10 +297,15 @@ private:
             {
                 handleMouseButtonDown();
             }
+            else if (event.type == SDL_MOUSEWHEEL && !switchToNextScreen && !viewNotesClicked && !deleteNotesClicked && !searchClicked && !calendarClicked && !moodClicked)
+            {
+                // the wheel scrolls the notes list a row per notch
+                notesList.scroll(-event.wheel.y * 70, journal.size());
+            }
             else if (switchToNextScreen)
             {
-                // Handle text input for the second screen
-                handleTextInput(inputText, renderText, textColor);
+                // Keys, typed text and the wheel go to the entry being written
+                editor.handleEvent(event);
             }
             else if (viewNotesClicked)
             {
@@ -251,56 +317,146 @@ private:
                 //it will ask for the entry  number to delete
                 handleFirstScreenTextInput(inputText, renderText, textColor, selectedEntryNumber, selectedEntryData, false, true);
             }
-        }
-    }
-    void DeleteNotesClicked()
-    {
-        RenderText("Enter Entry Number To Delete:", 460, 55, true);
-        gInputTextTexture.render(renderer, (SCREEN_WIDTH - gInputTextTexture.getWidth()) / 2, gPromptTextTexture.getHeight());
-
-        if (renderText)
-        {
-            if (inputText != "")
+            else if (calendarClicked && event.type == SDL_KEYDOWN && (event.key.keysym.sym == SDLK_LEFT || event.key.keysym.sym == SDLK_RIGHT))
             {
-                gInputTextTexture.loadFromRenderedText(renderer, font, inputText.c_str(), textColor);
+                // the arrow keys page through the months
+                calendar.shiftMonth(event.key.keysym.sym == SDLK_LEFT ? -1 : 1);
+                refreshCalendar();
             }
-            else
+            else if (moodClicked && event.type == SDL_KEYDOWN && (event.key.keysym.sym == SDLK_LEFT || event.key.keysym.sym == SDLK_RIGHT))
+            {
+                // the arrow keys page through the days a chart at a time
+                moodChart.shiftDays(event.key.keysym.sym == SDLK_LEFT ? -MOOD_CHART_DAYS : MOOD_CHART_DAYS);
+            }
+            else if (searchClicked)
             {
-                gInputTextTexture.loadFromRenderedText(renderer, font, " ", textColor);
+                // the query is run again whenever it changes
+                string query = inputText;
+                handleTextInput(inputText, renderText, textColor);
+                if (inputText != query)
+                {
+                    runSearch();
+                }
             }
         }
     }
+    void DeleteNotesClicked()
+    {
+        RenderText("Enter Entry Number To Delete:", 460, 55, true);
+        renderCentered(inputText, textRenderer.lineHeight(font));
+    }
     void ViewNotesClicked()
     {  
         RenderText("Enter Entry Number To View:", 460, 55, true);
-        gInputTextTexture.render(renderer, (SCREEN_WIDTH - gInputTextTexture.getWidth()) / 2, gPromptTextTexture.getHeight());
-
-        if (renderText)
+        renderCentered(inputText, textRenderer.lineHeight(font));
+        // The entry was read from the journal when its number was entered
+        if (selectedEntryNumber != -1)
+        {
+            RenderText(selectedEntryData, 450, 140, true);
+        }
+    }
+    void SearchClicked()
+    {
+        RenderText("Search (\"a phrase\", word*, #tag):", 460, 55, true);
+        renderCentered(inputText, textRenderer.lineHeight(font));
+        if (inputText != "" && searchResults.empty())
+        {
+            RenderText("No entries found.", 450, 140, true);
+        }
+        int listY = 140;
+        for (int number : searchResults)
+        {
+            RenderText("Entry No. " + to_string(number) + ": " + entryDate(journal.entry(number - 1).time), 430, listY, true);
+            listY += 70;
+        }
+    }
+    // Method to look up the search box's query; results are kept as entry numbers until the query changes.
+    // A query with a # in it is a tag filter, such as "#work AND NOT #sleep", listed newest first.
+    void runSearch()
+    {
+        searchResults.clear();
+        if (inputText.find('#') != string::npos)
         {
-            if (inputText != "")
+            RoaringBitmap matches;
+            vector<uint32_t> ids;
+            tags.filter(inputText, matches);
+            matches.largest((SCREEN_HEIGHT - 140) / 70, ids);
+            for (uint32_t id : ids)
             {
-                gInputTextTexture.loadFromRenderedText(renderer, font, inputText.c_str(), textColor);
+                int position = journal.index().find(id);
+                if (position >= 0)
+                {
+                    searchResults.push_back(position + 1);
+                }
             }
-            else
+            return;
+        }
+        vector<JournalHit> hits;
+        search.search(inputText, hits, (SCREEN_HEIGHT - 140) / 70);
+        for (const JournalHit &hit : hits)
+        {
+            int position = journal.index().find(hit.id);
+            if (position >= 0)
             {
-                gInputTextTexture.loadFromRenderedText(renderer, font, " ", textColor);
+                searchResults.push_back(position + 1);
             }
         }
-        // Check if a valid entry number is selected and fetch the associated data
-        if (selectedEntryNumber != -1)
+    }
+    void CalendarClicked()
+    {
+        calendar.render(renderer, textRenderer, font, textColor, timeline);
+        int listY = 100 + 8 * CALENDAR_CELL_HEIGHT;
+        RenderText(calendarSummary, 440, listY, false);
+        for (int i = 0; i < (int)calendarResults.size() && i < 3; i++)
         {
-            node *selectedNode = DoublyLinkedList.getNodeByIndex(selectedEntryNumber);
-            if (selectedNode)
+            listY += 45;
+            // The day is in the calendar already, so only the time is shown
+            RenderText("Entry No. " + to_string(calendarResults[i]) + " at " + entryDate(journal.entry(calendarResults[i] - 1).time).substr(11, 5), 440, listY, false);
+        }
+        if (calendarResults.size() > 3)
+        {
+            RenderText("and " + to_string(calendarResults.size() - 3) + " more", 440, listY + 45, false);
+        }
+    }
+    // Method to count the month's and the last week's entries, and list the entries of the picked day
+    void refreshCalendar()
+    {
+        vector<uint32_t> ids;
+        int64_t from, to;
+        calendarResults.clear();
+        if (calendar.selection(from, to))
+        {
+            timeline.range(from, to, ids);
+            for (uint32_t id : ids)
             {
-                selectedEntryData = selectedNode->getData();
-                // Render the associated data on the screen
-                RenderText(selectedEntryData, 450, 140, true);
-            }
-            else{
-                selectedEntryData = "Wrong Entry number!";  
-                RenderText(selectedEntryData, 450, 140, true); 
+                int position = journal.index().find(id);
+                if (position >= 0)
+                {
+                    calendarResults.push_back(position + 1);
+                }
             }
+            calendarSummary = "Entries that day: " + to_string(ids.size());
+            return;
         }
+        calendar.monthRange(from, to);
+        timeline.range(from, to, ids);
+        int month = ids.size();
+        // The last 7 days come from the per-day counts, without collecting their ids
+        time_t now = time(0);
+        tm today = *localtime(&now);
+        time_t weekStart = (time_t)journalDayStart(today.tm_year + 1900, today.tm_mon + 1, today.tm_mday - 6);
+        tm first = *localtime(&weekStart);
+        int week = timeline.countDays((first.tm_year + 1900) * 10000 + (first.tm_mon + 1) * 100 + first.tm_mday,
+                                      (today.tm_year + 1900) * 10000 + (today.tm_mon + 1) * 100 + today.tm_mday);
+        calendarSummary = "Month: " + to_string(month) + "  Last 7 days: " + to_string(week);
+    }
+    // There are no images for the search and calendar buttons, so they are drawn as framed labels
+    void renderFramedButton(const SDL_Rect &button, const string &label)
+    {
+        SDL_SetRenderDrawColor(renderer, textColor.r, textColor.g, textColor.b, textColor.a);
+        SDL_RenderDrawRect(renderer, &button);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        RenderText(label, button.x + (button.w - textRenderer.width(font, label)) / 2, button.y + 5, false);
     }
     //when next screen is switched (the screen where we put journal entry)
     void SwitchToNextScreen()
@@ -308,21 +464,8 @@ private:
         renderTexture(background2, renderer, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
         renderTexture(buttonBack, renderer, buttonBackRect.x, buttonBackRect.y, buttonBackRect.w, buttonBackRect.h);
 
-        gPromptTextTexture.render(renderer, (SCREEN_WIDTH - gPromptTextTexture.getWidth()) / 2, 0);
-        gInputTextTexture.render(renderer, (SCREEN_WIDTH - gInputTextTexture.getWidth()) / 2, gPromptTextTexture.getHeight());
-
-        if (renderText)
-        {
-            if (inputText != "")
-            {
-                RenderText(inputText.c_str(), 240, 80, true);
-            }
-            else
-            {
-
-                RenderText(" ", 240, 80, true);
-            }
-        }
+        renderCentered("Happy Journaling!", 0);
+        editor.render(renderer, {100, 205, 139, 255});
     }
     SDL_Texture *loadTexture(const string &path, SDL_Renderer *renderer)
     {
@@ -359,104 +502,49 @@ private:
         SDL_DestroyTexture(buttonViewNotes);
         SDL_DestroyTexture(buttonDeleteNotes);
     }
-    //displays notes list
-    void renderNotesList(SDL_Renderer *renderer, const SDL_Color &textColor, bool wrapText)
+    //displays notes list; only the rows in view are laid out, and their wrapped lines are kept between frames
+    void renderNotesList(SDL_Renderer *renderer, const SDL_Color &textColor)
     {
-        int listX = 430;
-        int listY = 100;
-        int lineHeight = 70;
         selectedEntryData = "";
         RenderText(selectedEntryData, 450, 140, true);
-        LTexture noteTextTexture;
-
-        node *current = DoublyLinkedList.head;
-
-        int noteCount = 0;
-        while (current != NULL)
+        notesList.render(renderer, textRenderer, layout, font, textColor, journal.index(), [this](int number, const JournalEntry &entry)
         {
-            std::string noteText = "Entry No. " + std::to_string(noteCount + 1) + ": " + current->getDateTime();
-
-            if (wrapText)
-            {
-                int wrapLength = 25;
-                std::vector<std::string> wrappedLines;
-
-                // Wrap the text
-                size_t startPos = 0;
-                while (startPos < noteText.length())
-                {
-                    size_t endPos = std::min(startPos + wrapLength, noteText.length());
-                    size_t lastSpace = noteText.find_last_of(" ", endPos);
-                    if (lastSpace != std::string::npos && lastSpace > startPos)
-                    {
-                        endPos = lastSpace;
-                    }
-                    wrappedLines.push_back(noteText.substr(startPos, endPos - startPos));
-                    startPos = endPos + 1;
-                }
-
-                int yOffset = listY;
-                for (const auto &line : wrappedLines)
-                {
-                    noteTextTexture.loadFromRenderedText(renderer, font, line, textColor);
-                    noteTextTexture.render(renderer, listX, yOffset);
-
-                    yOffset += noteTextTexture.getHeight(); // Adjust this value for spacing
-                }
-            }
-            else
-            {
-                noteTextTexture.loadFromRenderedText(renderer, font, noteText, textColor);
-                noteTextTexture.render(renderer, listX, listY);
-            }
-
-            listY += lineHeight;
-            current = current->next;
-            noteCount++;
-        }
-
-        noteTextTexture.free();
+            return "Entry No. " + to_string(number) + ": " + entryDate(entry.time);
+        });
+    }
+    // Method to format when an entry was written, as year-month-day hour:minute:second
+    string entryDate(int64_t written)
+    {
+        time_t when = (time_t)written;
+        tm *local = localtime(&when);
+        char buffer[30];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", local);
+        return buffer;
     }
     //displays text on screen
     void RenderText(string text, int x, int y, bool wrapText)
     {
-        SDL_Color textColor = {100, 205, 139};
-        LTexture noteTextTexture;
+        SDL_Color textColor = {100, 205, 139, 255};
         //to wrap the text so it doesnt go out of the width of screen
         if (wrapText)
         {
-            int wrapLength = 25;
-            vector<string> wrappedLines;
-
-            // Wrap the text
-            size_t startPos = 0;
-            while (startPos < text.length())
-            {
-                size_t endPos = min(startPos + wrapLength, text.length());
-                size_t lastSpace = text.find_last_of(" ", endPos);
-                if (lastSpace != string::npos && lastSpace > startPos)
-                {
-                    endPos = lastSpace;
-                }
-                wrappedLines.push_back(text.substr(startPos, endPos - startPos));
-                startPos = endPos + 1;
-            }
-
             int yOffset = y;
-            for (const auto &line : wrappedLines)
+            for (const TextLine &line : layout.wrap(font, text, WRAP_PIXELS))
             {
-                noteTextTexture.loadFromRenderedText(renderer, font, line, textColor);
-                noteTextTexture.render(renderer, x, yOffset);
-
-                yOffset += noteTextTexture.getHeight(); // value for spacing
+                textRenderer.draw(renderer, font, text, line.start, line.start + line.length, x, yOffset, textColor);
+                yOffset += textRenderer.lineHeight(font); // value for spacing
             }
         }
         else
         {
-            noteTextTexture.loadFromRenderedText(renderer, font, text, textColor);
-            noteTextTexture.render(renderer, x, y);
+            textRenderer.draw(renderer, font, text, x, y, textColor);
         }
     }
+    // Method to draw a line of text in the journal's text color, centered across the screen
+    void renderCentered(const string &text, int y)
+    {
+        textRenderer.draw(renderer, font, text, (SCREEN_WIDTH - textRenderer.width(font, text)) / 2, y, textColor);
+    }
     //when a keyboard key is pressed this function displays that input on screen
     void handleTextInput(string &inputText, bool &renderText, SDL_Color textColor)
     {
@@ -510,7 +598,7 @@ private:
                 try
                 {
                     selectedEntryNumber = stoi(inputText);
-                    if (selectedEntryNumber <= 0 || selectedEntryNumber > DoublyLinkedList.size())
+                    if (selectedEntryNumber <= 0 || selectedEntryNumber > journal.size())
                     {
                         // Invalid entry number, reset and render an error message
                         inputText = "";
@@ -522,29 +610,33 @@ private:
                     {
                         if (view)
                         {
-                            node *selectedNode = DoublyLinkedList.getNodeByIndex(selectedEntryNumber);
                             inputText = "";
                             renderText = true;
-                            if (selectedNode)
+                            // Only now is the entry's text read from disk
+                            if (!journal.read(selectedEntryNumber - 1, selectedEntryData))
                             {
-                                selectedEntryData = selectedNode->getData();
+                                selectedEntryData = "Could not read this entry!";
                             }
                         }
                         else if (dlt)
                         {
-                            node *selectedNode = DoublyLinkedList.getNodeByIndex(selectedEntryNumber);
-                            if (selectedNode)
+                            inputText = "";
+                            JournalEntry removed = journal.entry(selectedEntryNumber - 1);
+                            bool check = journal.remove(selectedEntryNumber - 1);
+                            if (check)
                             {
-                                inputText = "";
-                                bool check = DoublyLinkedList.deleteNode(selectedEntryNumber);
-                                if(!check){
-                                    selectedEntryData = "Wrong Entry number!";  
-                                    RenderText(selectedEntryData, 450, 140, true); 
-                                }
-                                else{
-                                    selectedEntryData = "Note " + to_string(selectedEntryNumber) + " deleted.";  
-                                    RenderText(selectedEntryData, 450, 140, true); 
-                                }
+                                search.remove(removed.id);
+                                tags.remove(removed.id);
+                                timeline.remove(removed.time, removed.id);
+                                mood.remove(removed.time, removed.id);
+                            }
+                            if(!check){
+                                selectedEntryData = "Wrong Entry number!";  
+                                RenderText(selectedEntryData, 450, 140, true); 
+                            }
+                            else{
+                                selectedEntryData = "Note " + to_string(selectedEntryNumber) + " deleted.";  
+                                RenderText(selectedEntryData, 450, 140, true); 
                             }
                         }
                     }
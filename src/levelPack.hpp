@@ -0,0 +1,343 @@
+#ifndef LEVEL_PACK_H
+#define LEVEL_PACK_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cstdint>
+#include <cstring>
+#include "flowGenerator.hpp"
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary level packs, version 1. All numbers are little-endian.
+//
+//   header (24 bytes): "FLWP", version, level count, size of everything after the header,
+//                      FNV-1a checksum of everything after the header, reserved
+//   index (16 bytes per level): body offset from the start of the file, rows and cols (16 bit),
+//                      colors (16 bit), difficulty (8 bit), flags (8 bit), reserved (32 bit)
+//   flags: bit 0 set when the body carries the solution, bits 1-2 the board topology (0 square, 1 hex, 2 torus)
+//   bodies: rows * cols cell bytes (0 empty, 1..colors endpoints), then, if flag 1 is set,
+//           rows * cols bytes of the full solution
+//
+// The pack is memory-mapped and checked once when opened; afterwards a level is just a pointer into the mapping.
+
+const uint32_t LEVEL_PACK_VERSION = 1;
+const int LEVEL_PACK_HEADER = 24;
+const int LEVEL_PACK_ENTRY = 16;
+const int LEVEL_PACK_SOLVED = 1; // flag: the body carries the solution
+const int LEVEL_PACK_TOPOLOGY_SHIFT = 1;
+const int LEVEL_PACK_TOPOLOGY_MASK = 3;
+
+// One level as stored in an open pack; the cell pointers stay valid until the pack is closed
+struct PackedLevel
+{
+    int rows, cols, colors, difficulty;
+    FlowTopology::Kind topology;
+    const uint8_t *cells;
+    const uint8_t *solution; // NULL when the pack has no solution for this level
+};
+
+// Function to compute the 32 bit FNV-1a hash used as the pack checksum
+inline uint32_t packChecksum(const uint8_t *data, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+inline uint32_t readLE(const uint8_t *p, int bytes)
+{
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+inline void writeLE(vector<uint8_t> &out, uint32_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out.push_back((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Function to write levels to a binary level pack
+inline bool writeLevelPack(const string &filename, const vector<FlowPuzzle> &levels)
+{
+    vector<uint8_t> data;
+    writeLE(data, 0x50574C46, 4); // "FLWP"
+    writeLE(data, LEVEL_PACK_VERSION, 4);
+    writeLE(data, levels.size(), 4);
+    writeLE(data, 0, 4); // body size, patched below
+    writeLE(data, 0, 4); // checksum, patched below
+    writeLE(data, 0, 4);
+    uint32_t offset = LEVEL_PACK_HEADER + LEVEL_PACK_ENTRY * levels.size();
+    for (const FlowPuzzle &level : levels)
+    {
+        int cells = level.rows * level.cols;
+        bool solved = (int)level.solution.size() == cells;
+        if (level.rows <= 0 || level.cols <= 0 || level.rows > 0xFFFF || level.cols > 0xFFFF || level.colors > 255 || (int)level.cells.size() != cells)
+        {
+            cerr << "Level does not fit the pack format: " << level.rows << "x" << level.cols << " with " << level.colors << " colors" << endl;
+            return false;
+        }
+        writeLE(data, offset, 4);
+        writeLE(data, level.rows, 2);
+        writeLE(data, level.cols, 2);
+        writeLE(data, level.colors, 2);
+        writeLE(data, min(max(level.difficulty, 0), 255), 1);
+        writeLE(data, (solved ? LEVEL_PACK_SOLVED : 0) | (level.topology << LEVEL_PACK_TOPOLOGY_SHIFT), 1);
+        writeLE(data, 0, 4);
+        offset += cells * (solved ? 2 : 1);
+    }
+    for (const FlowPuzzle &level : levels)
+    {
+        data.insert(data.end(), level.cells.begin(), level.cells.end());
+        if ((int)level.solution.size() == level.rows * level.cols)
+        {
+            data.insert(data.end(), level.solution.begin(), level.solution.end());
+        }
+    }
+    uint32_t body = data.size() - LEVEL_PACK_HEADER;
+    uint32_t checksum = packChecksum(data.data() + LEVEL_PACK_HEADER, body);
+    for (int i = 0; i < 4; i++)
+    {
+        data[12 + i] = (body >> (8 * i)) & 0xFF;
+        data[16 + i] = (checksum >> (8 * i)) & 0xFF;
+    }
+    ofstream file(filename, ios::binary);
+    if (!file.is_open())
+    {
+        cerr << "Error opening file: " << filename << endl;
+        return false;
+    }
+    file.write((const char *)&data[0], data.size());
+    return file.good();
+}
+
+// A read-only, memory-mapped binary level pack
+class LevelPack
+{
+public:
+    LevelPack() : base(NULL), length(0), count(0)
+    {
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mapping = NULL;
+#endif
+    }
+    ~LevelPack()
+    {
+        close();
+    }
+
+    // Method to map a pack and validate its header, index and checksum; false leaves the pack closed
+    bool open(const string &filename)
+    {
+        close();
+        if (!map(filename))
+        {
+            return false;
+        }
+        if (!validate())
+        {
+            cerr << "Invalid level pack: " << filename << endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        if (base != NULL)
+        {
+#ifdef _WIN32
+            UnmapViewOfFile(base);
+#else
+            munmap((void *)base, length);
+#endif
+        }
+#ifdef _WIN32
+        if (mapping != NULL)
+        {
+            CloseHandle(mapping);
+        }
+        if (fileHandle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(fileHandle);
+        }
+        mapping = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+#endif
+        base = NULL;
+        length = 0;
+        count = 0;
+    }
+
+    bool isOpen() const
+    {
+        return base != NULL;
+    }
+
+    int size() const
+    {
+        return count;
+    }
+
+    // Method to look up level i (0-based); no parsing or copying, only index arithmetic
+    bool level(int i, PackedLevel &out) const
+    {
+        if (i < 0 || i >= count)
+        {
+            return false;
+        }
+        const uint8_t *entry = base + LEVEL_PACK_HEADER + i * LEVEL_PACK_ENTRY;
+        out.rows = readLE(entry + 4, 2);
+        out.cols = readLE(entry + 6, 2);
+        out.colors = readLE(entry + 8, 2);
+        out.difficulty = entry[10];
+        out.topology = (FlowTopology::Kind)((entry[11] >> LEVEL_PACK_TOPOLOGY_SHIFT) & LEVEL_PACK_TOPOLOGY_MASK);
+        out.cells = base + readLE(entry, 4);
+        out.solution = (entry[11] & LEVEL_PACK_SOLVED) ? out.cells + out.rows * out.cols : NULL;
+        return true;
+    }
+
+    // Method to copy level i out of the pack, for tools that edit or merge packs
+    bool level(int i, FlowPuzzle &out) const
+    {
+        PackedLevel packed;
+        if (!level(i, packed))
+        {
+            return false;
+        }
+        int cells = packed.rows * packed.cols;
+        out.rows = packed.rows;
+        out.cols = packed.cols;
+        out.colors = packed.colors;
+        out.difficulty = packed.difficulty;
+        out.topology = packed.topology;
+        out.cells.assign(packed.cells, packed.cells + cells);
+        out.solution.clear();
+        if (packed.solution != NULL)
+        {
+            out.solution.assign(packed.solution, packed.solution + cells);
+        }
+        return true;
+    }
+
+private:
+    const uint8_t *base;
+    size_t length;
+    int count;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mapping;
+#endif
+
+    LevelPack(const LevelPack &);
+    LevelPack &operator=(const LevelPack &);
+
+    bool map(const string &filename)
+    {
+#ifdef _WIN32
+        fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            cerr << "Error opening file: " << filename << endl;
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart < LEVEL_PACK_HEADER)
+        {
+            cerr << "Level pack is too small: " << filename << endl;
+            close();
+            return false;
+        }
+        length = (size_t)fileSize.QuadPart;
+        mapping = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        base = mapping != NULL ? (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            cerr << "Error opening file: " << filename << endl;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < LEVEL_PACK_HEADER)
+        {
+            cerr << "Level pack is too small: " << filename << endl;
+            ::close(fd);
+            return false;
+        }
+        length = info.st_size;
+        void *view = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        base = view != MAP_FAILED ? (const uint8_t *)view : NULL;
+#endif
+        if (base == NULL)
+        {
+            cerr << "Failed to map level pack: " << filename << endl;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Every offset is checked here once, so level() can trust the index
+    bool validate()
+    {
+        if (memcmp(base, "FLWP", 4) != 0 || readLE(base + 4, 4) != LEVEL_PACK_VERSION)
+        {
+            return false;
+        }
+        uint32_t levels = readLE(base + 8, 4);
+        uint32_t body = readLE(base + 12, 4);
+        if (body != length - LEVEL_PACK_HEADER || levels > (length - LEVEL_PACK_HEADER) / LEVEL_PACK_ENTRY)
+        {
+            return false;
+        }
+        if (packChecksum(base + LEVEL_PACK_HEADER, body) != readLE(base + 16, 4))
+        {
+            return false;
+        }
+        count = levels;
+        for (int i = 0; i < count; i++)
+        {
+            const uint8_t *entry = base + LEVEL_PACK_HEADER + i * LEVEL_PACK_ENTRY;
+            size_t offset = readLE(entry, 4);
+            size_t cells = (size_t)readLE(entry + 4, 2) * readLE(entry + 6, 2);
+            size_t bytes = cells * ((entry[11] & LEVEL_PACK_SOLVED) ? 2 : 1);
+            uint32_t colors = readLE(entry + 8, 2);
+            if (cells == 0 || ((entry[11] >> LEVEL_PACK_TOPOLOGY_SHIFT) & LEVEL_PACK_TOPOLOGY_MASK) > FlowTopology::TORUS || offset < LEVEL_PACK_HEADER + (size_t)count * LEVEL_PACK_ENTRY || offset + bytes > length)
+            {
+                return false;
+            }
+            for (size_t c = 0; c < bytes; c++)
+            {
+                if (base[offset + c] > colors)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+#endif
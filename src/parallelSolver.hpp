@@ -0,0 +1,135 @@
+#ifndef PARALLEL_SOLVER_H
+#define PARALLEL_SOLVER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include "flowSolver.hpp"
+#include "threadPool.hpp"
+
+const int MAX_SPLIT_DEPTH = 64;    // deepest level the tree is cut at when forced moves keep branches scarce
+const int BRANCHES_PER_WORKER = 8; // spare branches let idle workers steal when some branches finish early
+
+// Runs FlowSolver over a ThreadPool. The top of the search tree is expanded on the calling thread until it has
+// several open branches per worker; each branch is then searched by its own copy of the solver as a pool job.
+// The branches share a node budget and a solution count, and stop together as soon as enough solutions are found.
+// Calling solve() from a pool job is fine: the caller runs branches itself while it waits.
+class ParallelSolver
+{
+public:
+    ParallelSolver(ThreadPool &workers) : pool(workers), found(0), aborted(false) {}
+
+    bool load(int r, int c, const vector<int> &cells)
+    {
+        return root.load(r, c, cells);
+    }
+    bool load(const FlowTopology &topology, const vector<int> &cells)
+    {
+        return root.load(topology, cells);
+    }
+
+    // Method to search for up to maxCount solutions, giving up after limit nodes in total (-1 for no limit)
+    int solve(int maxCount = 1, long long limit = -1)
+    {
+        stats = SolverStats();
+        solutionCells.clear();
+        aborted = false;
+        // Grow the set of open branches one move at a time until every worker has several to work on
+        vector<FlowSolver> tasks(1, root), children;
+        int depth = 0;
+        found = 0;
+        while (found < maxCount && !tasks.empty() && (int)tasks.size() < pool.size() * BRANCHES_PER_WORKER && depth < MAX_SPLIT_DEPTH)
+        {
+            vector<FlowSolver> next;
+            for (FlowSolver &task : tasks)
+            {
+                found += task.split(1, maxCount - found, children);
+                addStats(task.getStats(), depth);
+                if (solutionCells.empty() && !task.solution().empty())
+                {
+                    solutionCells = task.solution();
+                }
+                next.insert(next.end(), children.begin(), children.end());
+                if (found >= maxCount)
+                {
+                    break;
+                }
+            }
+            tasks.swap(next);
+            depth++;
+        }
+        if (found >= maxCount || tasks.empty())
+        {
+            return min(found, maxCount);
+        }
+
+        atomic<bool> cancel(false);
+        atomic<long long> nodes(stats.nodes);
+        atomic<int> solutions(found);
+        SDL_sem *finished = SDL_CreateSemaphore(0);
+        for (FlowSolver &task : tasks)
+        {
+            FlowSolver *branch = &task;
+            branch->share(&cancel, &nodes, &solutions);
+            pool.submit([branch, maxCount, limit, finished]()
+            {
+                branch->solve(maxCount, limit);
+                SDL_SemPost(finished);
+            });
+        }
+        // Run queued branches here while waiting; once none are left, sleep until the running ones finish
+        int done = 0;
+        while (done < (int)tasks.size())
+        {
+            if (SDL_SemTryWait(finished) == 0 || (!pool.runOne() && SDL_SemWaitTimeout(finished, 1) == 0))
+            {
+                done++;
+            }
+        }
+        SDL_DestroySemaphore(finished);
+
+        for (FlowSolver &task : tasks)
+        {
+            addStats(task.getStats(), depth);
+            aborted = aborted || task.exhausted();
+            if (solutionCells.empty() && !task.solution().empty())
+            {
+                solutionCells = task.solution();
+            }
+        }
+        found = min(solutions.load(), maxCount);
+        aborted = aborted && found < maxCount;
+        return found;
+    }
+
+    // True when the last solve() stopped because it ran out of its node budget
+    bool exhausted() const
+    {
+        return aborted;
+    }
+
+    // Row-major colors of a solution found by the last solve()
+    const vector<int> &solution() const
+    {
+        return solutionCells;
+    }
+
+    // Work summed over every branch
+    const SolverStats &getStats() const
+    {
+        return stats;
+    }
+
+private:
+    ThreadPool &pool;
+    FlowSolver root;
+    int found;
+    bool aborted;
+    SolverStats stats;
+    vector<int> solutionCells;
+
+    void addStats(const SolverStats &part, int depthOffset)
+    {
+        stats.nodes += part.nodes;
+        stats.backtracks += part.backtracks;
+        stats.maxDepth = max(stats.maxDepth, part.maxDepth + depthOffset);
+    }
+};
+#endif
@@ -117,20 +117,7 @@ private:
 
     // Render the question text
     SDL_Color textColor = {0, 0, 82, 180}; // Purple text color
-    SDL_Surface* textSurface = TTF_RenderText_Solid(font, node->question.c_str(), textColor);
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-
-    // Get the dimensions of the rendered text
-    int textWidth, textHeight;
-    SDL_QueryTexture(textTexture, NULL, NULL, &textWidth, &textHeight);
-
-    // Define the rectangle for rendering the text
-    SDL_Rect textRect = {160, 50, textWidth, textHeight};
-    SDL_RenderCopy(renderer, textTexture, NULL, &textRect);
-
-    // Clean up the texture and surface resources
-    SDL_DestroyTexture(textTexture);
-    SDL_FreeSurface(textSurface);
+    textRenderer.draw(renderer, font, node->question, 160, 50, textColor);
 
     // Render buttons only if it's not a leaf node
     if (node->trueOption || node->falseOption)
@@ -0,0 +1,525 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+using namespace std;
+
+const int ROARING_ARRAY_MAX = 4096; // values a container keeps as a sorted array before it becomes a bitset
+const int ROARING_WORDS = 1024;     // 64-bit words in a bitset container, one bit for each of 65536 values
+
+// Set bits in a word; the builtin is a library call unless the compiler may assume a popcount instruction
+inline int roaringCount(uint64_t word)
+{
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (word * 0x0101010101010101ULL) >> 56;
+}
+
+// A compressed set of 32-bit values in the style of a roaring bitmap.
+// Values are split by their high 16 bits into containers. A container with few values keeps them as a sorted
+// array of their low 16 bits, and one with more than ROARING_ARRAY_MAX keeps an 8 KB bitset instead, so no
+// container is ever bigger than either. Intersections, unions and differences run container by container:
+// bitset pairs a word at a time, array pairs as a merge, and mixed pairs by looking the array's values up in the
+// bitset.
+class RoaringBitmap
+{
+public:
+    void add(uint32_t value)
+    {
+        Container &container = at(value >> 16);
+        uint16_t low = value & 0xFFFF;
+        if (container.isBitset())
+        {
+            uint64_t &word = container.bits[low >> 6];
+            if (!(word & (1ULL << (low & 63))))
+            {
+                word |= 1ULL << (low & 63);
+                container.count++;
+            }
+            return;
+        }
+        vector<uint16_t>::iterator it = lower_bound(container.values.begin(), container.values.end(), low);
+        if (it == container.values.end() || *it != low)
+        {
+            container.values.insert(it, low);
+            container.count++;
+            tidy(container);
+        }
+    }
+
+    void remove(uint32_t value)
+    {
+        vector<Container>::iterator found = find(value >> 16);
+        if (found == containers.end())
+        {
+            return;
+        }
+        Container &container = *found;
+        uint16_t low = value & 0xFFFF;
+        if (container.isBitset())
+        {
+            uint64_t &word = container.bits[low >> 6];
+            if (word & (1ULL << (low & 63)))
+            {
+                word &= ~(1ULL << (low & 63));
+                container.count--;
+                tidy(container);
+            }
+        }
+        else
+        {
+            vector<uint16_t>::iterator it = lower_bound(container.values.begin(), container.values.end(), low);
+            if (it != container.values.end() && *it == low)
+            {
+                container.values.erase(it);
+                container.count--;
+            }
+        }
+        if (container.count == 0)
+        {
+            containers.erase(found);
+        }
+    }
+
+    bool contains(uint32_t value) const
+    {
+        vector<Container>::const_iterator found = find(value >> 16);
+        return found != containers.end() && found->contains(value & 0xFFFF);
+    }
+
+    uint32_t size() const
+    {
+        uint32_t total = 0;
+        for (const Container &container : containers)
+        {
+            total += container.count;
+        }
+        return total;
+    }
+
+    bool empty() const
+    {
+        return containers.empty();
+    }
+
+    void clear()
+    {
+        containers.clear();
+    }
+
+    // Method to keep only the values also in other
+    void intersect(const RoaringBitmap &other)
+    {
+        vector<Container> result;
+        vector<Container>::const_iterator a = containers.begin(), b = other.containers.begin();
+        while (a != containers.end() && b != other.containers.end())
+        {
+            if (a->key < b->key)
+            {
+                ++a;
+            }
+            else if (b->key < a->key)
+            {
+                ++b;
+            }
+            else
+            {
+                Container both;
+                both.key = a->key;
+                both.count = 0;
+                if (!a->isBitset() && !b->isBitset())
+                {
+                    both.values.resize(min(a->values.size(), b->values.size()));
+                    both.values.erase(set_intersection(a->values.begin(), a->values.end(), b->values.begin(), b->values.end(), both.values.begin()), both.values.end());
+                    both.count = both.values.size();
+                }
+                else if (!a->isBitset() || !b->isBitset())
+                {
+                    // The array in the pair bounds the result, so only its values are looked up in the bitset
+                    const Container &array = a->isBitset() ? *b : *a, &lookup = a->isBitset() ? *a : *b;
+                    for (uint16_t low : array.values)
+                    {
+                        if (lookup.contains(low))
+                        {
+                            both.values.push_back(low);
+                        }
+                    }
+                    both.count = both.values.size();
+                }
+                else
+                {
+                    both.bits.resize(ROARING_WORDS);
+                    for (int w = 0; w < ROARING_WORDS; w++)
+                    {
+                        both.bits[w] = a->bits[w] & b->bits[w];
+                        both.count += roaringCount(both.bits[w]);
+                    }
+                    tidy(both);
+                }
+                if (both.count > 0)
+                {
+                    result.push_back(both);
+                }
+                ++a;
+                ++b;
+            }
+        }
+        containers.swap(result);
+    }
+
+    // Method to add every value in other
+    void unite(const RoaringBitmap &other)
+    {
+        vector<Container> result;
+        vector<Container>::const_iterator a = containers.begin(), b = other.containers.begin();
+        while (a != containers.end() || b != other.containers.end())
+        {
+            if (b == other.containers.end() || (a != containers.end() && a->key < b->key))
+            {
+                result.push_back(*a++);
+            }
+            else if (a == containers.end() || b->key < a->key)
+            {
+                result.push_back(*b++);
+            }
+            else
+            {
+                Container either;
+                either.key = a->key;
+                if (!a->isBitset() && !b->isBitset())
+                {
+                    either.values.resize(a->values.size() + b->values.size());
+                    either.values.erase(set_union(a->values.begin(), a->values.end(), b->values.begin(), b->values.end(), either.values.begin()), either.values.end());
+                    either.count = either.values.size();
+                }
+                else
+                {
+                    either.bits = a->isBitset() ? a->bits : b->bits;
+                    const Container &rest = a->isBitset() ? *b : *a;
+                    if (rest.isBitset())
+                    {
+                        for (int w = 0; w < ROARING_WORDS; w++)
+                        {
+                            either.bits[w] |= rest.bits[w];
+                        }
+                    }
+                    else
+                    {
+                        for (uint16_t low : rest.values)
+                        {
+                            either.bits[low >> 6] |= 1ULL << (low & 63);
+                        }
+                    }
+                    either.count = 0;
+                    for (int w = 0; w < ROARING_WORDS; w++)
+                    {
+                        either.count += roaringCount(either.bits[w]);
+                    }
+                }
+                tidy(either);
+                result.push_back(either);
+                ++a;
+                ++b;
+            }
+        }
+        containers.swap(result);
+    }
+
+    // Method to drop every value that is in other
+    void subtract(const RoaringBitmap &other)
+    {
+        vector<Container> result;
+        vector<Container>::const_iterator b = other.containers.begin();
+        for (const Container &a : containers)
+        {
+            while (b != other.containers.end() && b->key < a.key)
+            {
+                ++b;
+            }
+            if (b == other.containers.end() || b->key != a.key)
+            {
+                result.push_back(a);
+                continue;
+            }
+            Container rest;
+            rest.key = a.key;
+            rest.count = 0;
+            if (!a.isBitset() && !b->isBitset())
+            {
+                rest.values.resize(a.values.size());
+                rest.values.erase(set_difference(a.values.begin(), a.values.end(), b->values.begin(), b->values.end(), rest.values.begin()), rest.values.end());
+                rest.count = rest.values.size();
+            }
+            else if (!a.isBitset())
+            {
+                for (uint16_t low : a.values)
+                {
+                    if (!b->contains(low))
+                    {
+                        rest.values.push_back(low);
+                    }
+                }
+                rest.count = rest.values.size();
+            }
+            else
+            {
+                rest.bits = a.bits;
+                if (b->isBitset())
+                {
+                    for (int w = 0; w < ROARING_WORDS; w++)
+                    {
+                        rest.bits[w] &= ~b->bits[w];
+                    }
+                }
+                else
+                {
+                    for (uint16_t low : b->values)
+                    {
+                        rest.bits[low >> 6] &= ~(1ULL << (low & 63));
+                    }
+                }
+                for (int w = 0; w < ROARING_WORDS; w++)
+                {
+                    rest.count += roaringCount(rest.bits[w]);
+                }
+                tidy(rest);
+            }
+            if (rest.count > 0)
+            {
+                result.push_back(rest);
+            }
+        }
+        containers.swap(result);
+    }
+
+    // Method to list the values in increasing order
+    void values(vector<uint32_t> &out) const
+    {
+        out.clear();
+        for (const Container &container : containers)
+        {
+            uint32_t high = (uint32_t)container.key << 16;
+            if (!container.isBitset())
+            {
+                for (uint16_t low : container.values)
+                {
+                    out.push_back(high | low);
+                }
+                continue;
+            }
+            for (int w = 0; w < ROARING_WORDS; w++)
+            {
+                for (uint64_t word = container.bits[w]; word != 0; word &= word - 1)
+                {
+                    out.push_back(high | (w << 6) | __builtin_ctzll(word));
+                }
+            }
+        }
+    }
+
+    // Method to list up to n of the largest values, largest first
+    void largest(size_t n, vector<uint32_t> &out) const
+    {
+        out.clear();
+        for (vector<Container>::const_reverse_iterator container = containers.rbegin(); container != containers.rend() && out.size() < n; ++container)
+        {
+            uint32_t high = (uint32_t)container->key << 16;
+            if (!container->isBitset())
+            {
+                for (vector<uint16_t>::const_reverse_iterator low = container->values.rbegin(); low != container->values.rend() && out.size() < n; ++low)
+                {
+                    out.push_back(high | *low);
+                }
+                continue;
+            }
+            for (int w = ROARING_WORDS - 1; w >= 0 && out.size() < n; w--)
+            {
+                for (uint64_t word = container->bits[w]; word != 0 && out.size() < n; word &= ~(1ULL << (63 - __builtin_clzll(word))))
+                {
+                    out.push_back(high | (w << 6) | (63 - __builtin_clzll(word)));
+                }
+            }
+        }
+    }
+
+    // Method to append the bitmap to out: the container count, then per container its key, its value count - 1
+    // and either its sorted values (2 bytes each) or its bitset (8 KB), all little-endian
+    void serialize(vector<uint8_t> &out) const
+    {
+        put(out, containers.size(), 4);
+        for (const Container &container : containers)
+        {
+            put(out, container.key, 2);
+            put(out, container.count - 1, 2);
+            if (container.isBitset())
+            {
+                for (uint64_t word : container.bits)
+                {
+                    put(out, word, 8);
+                }
+            }
+            else
+            {
+                for (uint16_t low : container.values)
+                {
+                    put(out, low, 2);
+                }
+            }
+        }
+    }
+
+    // Method to read a bitmap written by serialize, moving p past it; false when the bytes are not a valid one
+    bool deserialize(const uint8_t *&p, const uint8_t *end)
+    {
+        clear();
+        if (end - p < 4)
+        {
+            return false;
+        }
+        uint32_t count = get(p, 4);
+        while (count-- > 0)
+        {
+            if (end - p < 4)
+            {
+                return false;
+            }
+            Container container;
+            container.key = get(p, 2);
+            container.count = get(p, 2) + 1;
+            if (!containers.empty() && containers.back().key >= container.key)
+            {
+                return false;
+            }
+            if (container.count > ROARING_ARRAY_MAX)
+            {
+                if (end - p < ROARING_WORDS * 8)
+                {
+                    return false;
+                }
+                container.bits.resize(ROARING_WORDS);
+                uint32_t found = 0;
+                for (int w = 0; w < ROARING_WORDS; w++)
+                {
+                    container.bits[w] = get(p, 8);
+                    found += roaringCount(container.bits[w]);
+                }
+                if (found != container.count)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                if ((uint32_t)(end - p) < container.count * 2)
+                {
+                    return false;
+                }
+                container.values.resize(container.count);
+                for (uint32_t i = 0; i < container.count; i++)
+                {
+                    container.values[i] = get(p, 2);
+                    if (i > 0 && container.values[i] <= container.values[i - 1])
+                    {
+                        return false;
+                    }
+                }
+            }
+            containers.push_back(container);
+        }
+        return true;
+    }
+
+private:
+    struct Container
+    {
+        uint16_t key;           // high 16 bits of the values
+        uint32_t count;         // values held
+        vector<uint16_t> values; // sorted low 16 bits, while the container is an array
+        vector<uint64_t> bits;   // ROARING_WORDS words, once it is a bitset
+
+        bool isBitset() const
+        {
+            return !bits.empty();
+        }
+        bool contains(uint16_t low) const
+        {
+            return isBitset() ? (bits[low >> 6] >> (low & 63)) & 1 : binary_search(values.begin(), values.end(), low);
+        }
+    };
+    vector<Container> containers; // sorted by key
+
+    vector<Container>::iterator find(uint16_t key)
+    {
+        vector<Container>::iterator it = lower_bound(containers.begin(), containers.end(), key, [](const Container &c, uint16_t k) { return c.key < k; });
+        return it != containers.end() && it->key == key ? it : containers.end();
+    }
+    vector<Container>::const_iterator find(uint16_t key) const
+    {
+        vector<Container>::const_iterator it = lower_bound(containers.begin(), containers.end(), key, [](const Container &c, uint16_t k) { return c.key < k; });
+        return it != containers.end() && it->key == key ? it : containers.end();
+    }
+
+    // Method to find the container for a key, making an empty array container for it if there is none
+    Container &at(uint16_t key)
+    {
+        vector<Container>::iterator it = lower_bound(containers.begin(), containers.end(), key, [](const Container &c, uint16_t k) { return c.key < k; });
+        if (it == containers.end() || it->key != key)
+        {
+            Container container;
+            container.key = key;
+            container.count = 0;
+            it = containers.insert(it, container);
+        }
+        return *it;
+    }
+
+    // Method to switch a container between array and bitset when its count crosses ROARING_ARRAY_MAX
+    static void tidy(Container &container)
+    {
+        if (!container.isBitset() && container.count > ROARING_ARRAY_MAX)
+        {
+            container.bits.assign(ROARING_WORDS, 0);
+            for (uint16_t low : container.values)
+            {
+                container.bits[low >> 6] |= 1ULL << (low & 63);
+            }
+            vector<uint16_t>().swap(container.values);
+        }
+        else if (container.isBitset() && container.count <= ROARING_ARRAY_MAX)
+        {
+            container.values.clear();
+            container.values.reserve(container.count);
+            for (int w = 0; w < ROARING_WORDS; w++)
+            {
+                for (uint64_t word = container.bits[w]; word != 0; word &= word - 1)
+                {
+                    container.values.push_back((w << 6) | __builtin_ctzll(word));
+                }
+            }
+            vector<uint64_t>().swap(container.bits);
+        }
+    }
+
+    static void put(vector<uint8_t> &out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; i++)
+        {
+            out.push_back(value >> (8 * i));
+        }
+    }
+    static uint64_t get(const uint8_t *&p, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++)
+        {
+            value |= (uint64_t)p[i] << (8 * i);
+        }
+        p += bytes;
+        return value;
+    }
+};
+#endif
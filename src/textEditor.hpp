@@ -0,0 +1,598 @@
+#ifndef TEXT_EDITOR_H
+#define TEXT_EDITOR_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include "gapBuffer.hpp"
+#include "textLayout.hpp"
+using namespace std;
+
+// A multi-line text box: a gap buffer of UTF-8 text with a cursor, a selection and a scrolling view.
+// The text is kept as paragraphs (runs between newlines), each with its wrapped lines. An edit inside one paragraph
+// lays out again from the line before the edit and stops as soon as a line starts where an old one did, so typing
+// re-measures a line or two however long the entry is. Only the lines inside the view are drawn.
+class TextEditor
+{
+public:
+    TextEditor(TextRenderer &renderer, SDL_Rect area) : glyphs(renderer), layout(renderer), font(NULL), view(area), cursor(0), anchor(0), goalX(-1), scrollY(0), edits(0)
+    {
+        paragraphs.push_back(Paragraph());
+        layoutParagraph(0, 0);
+    }
+
+    // Method to set the font and lay every paragraph out with it
+    void setFont(TTF_Font *f)
+    {
+        font = f;
+        size_t start = 0;
+        for (int p = 0; p < (int)paragraphs.size(); p++)
+        {
+            layoutParagraph(p, start);
+            start += paragraphs[p].length + 1;
+        }
+        keepCursorVisible();
+    }
+
+    string text() const
+    {
+        return buffer.text();
+    }
+
+    bool empty() const
+    {
+        return buffer.size() == 0;
+    }
+
+    // Number of edits made so far; it changes whenever the text does, so a copy of the text can tell it is stale
+    uint32_t version() const
+    {
+        return edits;
+    }
+
+    // Method to replace all the text, leaving the cursor at its end
+    void setText(const string &text)
+    {
+        // Emptying a text that had something in it is an edit too; replace only counts the new text
+        if (buffer.size() > 0)
+        {
+            edits++;
+        }
+        buffer.clear();
+        paragraphs.assign(1, Paragraph());
+        cursor = anchor = 0;
+        scrollY = 0;
+        layoutParagraph(0, 0);
+        replace(0, 0, text);
+    }
+
+    void clear()
+    {
+        setText("");
+    }
+
+    bool contains(int x, int y) const
+    {
+        SDL_Point point = {x, y};
+        return SDL_PointInRect(&point, &view);
+    }
+
+    // Method to react to a key press, typed text or the mouse wheel; returns whether the event was used
+    bool handleEvent(const SDL_Event &event)
+    {
+        if (event.type == SDL_TEXTINPUT)
+        {
+            // Ctrl+C and Ctrl+V are handled as keys; some platforms also send them as text
+            char typed = event.text.text[0];
+            if (SDL_GetModState() & KMOD_CTRL && (typed == 'c' || typed == 'C' || typed == 'v' || typed == 'V' || typed == 'x' || typed == 'X' || typed == 'a' || typed == 'A'))
+            {
+                return false;
+            }
+            type(event.text.text);
+            return true;
+        }
+        if (event.type == SDL_MOUSEWHEEL)
+        {
+            scroll(-event.wheel.y * 3 * rowHeight());
+            return true;
+        }
+        if (event.type == SDL_KEYDOWN)
+        {
+            return handleKey(event.key.keysym.sym, SDL_GetModState());
+        }
+        return false;
+    }
+
+    // Method to put the cursor at a point in the view; with extend the selection grows to it instead
+    void click(int x, int y, bool extend)
+    {
+        int row = (y - view.y + scrollY) / rowHeight();
+        Place line = placeRow(row);
+        moveTo(positionAt(line, x - view.x), extend);
+    }
+
+    void scroll(int pixels)
+    {
+        scrollY = max(0, min(scrollY + pixels, maxScroll()));
+    }
+
+    // Method to draw the visible lines, the selection behind them and the cursor
+    void render(SDL_Renderer *renderer, SDL_Color color)
+    {
+        int height = rowHeight();
+        size_t selectionStart = min(cursor, anchor), selectionEnd = max(cursor, anchor);
+        SDL_RenderSetClipRect(renderer, &view);
+        int row = 0;
+        size_t start = 0;
+        for (int p = 0; p < (int)paragraphs.size(); p++)
+        {
+            const Paragraph &paragraph = paragraphs[p];
+            // Paragraphs wholly above the view are skipped without looking at their lines
+            if ((row + (int)paragraph.lines.size()) * height <= scrollY)
+            {
+                row += paragraph.lines.size();
+                start += paragraph.length + 1;
+                continue;
+            }
+            for (int l = 0; l < (int)paragraph.lines.size(); l++, row++)
+            {
+                int y = view.y + row * height - scrollY;
+                if (y >= view.y + view.h)
+                {
+                    break;
+                }
+                if (y + height <= view.y)
+                {
+                    continue;
+                }
+                size_t lineStart = start + paragraph.lines[l].start;
+                size_t lineEnd = lineStart + paragraph.lines[l].length;
+                buffer.copy(lineStart, lineEnd - lineStart, scratch);
+                if (selectionStart < selectionEnd && selectionStart <= lineEnd && selectionEnd > lineStart)
+                {
+                    int left = measure(lineStart, max(selectionStart, lineStart));
+                    int right = selectionEnd > lineEnd ? view.w : measure(lineStart, selectionEnd);
+                    SDL_Rect selected = {view.x + left, y, right - left, height};
+                    SDL_SetRenderDrawColor(renderer, 200, 220, 255, 255);
+                    SDL_RenderFillRect(renderer, &selected);
+                }
+                glyphs.draw(renderer, font, scratch, view.x, y, color);
+            }
+            if (row * height - scrollY >= view.h)
+            {
+                break;
+            }
+            start += paragraph.length + 1;
+        }
+        // The cursor blinks twice a second
+        if (SDL_GetTicks() / 500 % 2 == 0)
+        {
+            Place at = place(cursor);
+            SDL_Rect caret = {view.x + measure(at.start + paragraphs[at.paragraph].lines[at.line].start, cursor), view.y + at.row * height - scrollY, 2, height};
+            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+            SDL_RenderFillRect(renderer, &caret);
+        }
+        SDL_RenderSetClipRect(renderer, NULL);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    }
+
+private:
+    struct Paragraph
+    {
+        size_t length;          // bytes, not counting the newline after it
+        vector<TextLine> lines; // wrapped lines, relative to the paragraph's first byte
+        Paragraph() : length(0) {}
+    };
+    // Where a text position is: its paragraph and that paragraph's first byte, its line there, and its row on screen
+    struct Place
+    {
+        int paragraph;
+        size_t start;
+        int line;
+        int row;
+    };
+    TextRenderer &glyphs;
+    TextLayout layout;
+    TTF_Font *font;
+    SDL_Rect view;
+    GapBuffer buffer;
+    vector<Paragraph> paragraphs;
+    size_t cursor, anchor; // byte positions; the selection is the text between them
+    int goalX;             // pixels from the line start that up and down keep to, -1 when unset
+    int scrollY;           // pixels of text above the top of the view
+    string scratch;        // the bytes of one paragraph or line, copied out to be measured or drawn
+    uint32_t edits;        // replacements that changed the text, including whole-text ones
+
+    TextEditor(const TextEditor &);
+    TextEditor &operator=(const TextEditor &);
+
+    int rowHeight()
+    {
+        return max(1, glyphs.lineHeight(font));
+    }
+
+    int wrapWidth() const
+    {
+        return view.w - 10; // room for the cursor after the last character
+    }
+
+    int rows() const
+    {
+        int count = 0;
+        for (const Paragraph &paragraph : paragraphs)
+        {
+            count += paragraph.lines.size();
+        }
+        return count;
+    }
+
+    int maxScroll()
+    {
+        return max(0, rows() * rowHeight() - view.h);
+    }
+
+    bool handleKey(SDL_Keycode key, int modifiers)
+    {
+        bool ctrl = modifiers & KMOD_CTRL, shift = modifiers & KMOD_SHIFT;
+        size_t selectionStart = min(cursor, anchor), selectionEnd = max(cursor, anchor);
+        switch (key)
+        {
+        case SDLK_LEFT:
+            moveTo(selectionStart < selectionEnd && !shift ? selectionStart : (ctrl ? wordBefore(cursor) : charBefore(cursor)), shift);
+            return true;
+        case SDLK_RIGHT:
+            moveTo(selectionStart < selectionEnd && !shift ? selectionEnd : (ctrl ? wordAfter(cursor) : charAfter(cursor)), shift);
+            return true;
+        case SDLK_UP:
+            moveRows(-1, shift);
+            return true;
+        case SDLK_DOWN:
+            moveRows(1, shift);
+            return true;
+        case SDLK_PAGEUP:
+            moveRows(-max(1, view.h / rowHeight() - 1), shift);
+            return true;
+        case SDLK_PAGEDOWN:
+            moveRows(max(1, view.h / rowHeight() - 1), shift);
+            return true;
+        case SDLK_HOME:
+        {
+            Place at = place(cursor);
+            moveTo(ctrl ? 0 : at.start + paragraphs[at.paragraph].lines[at.line].start, shift);
+            return true;
+        }
+        case SDLK_END:
+        {
+            Place at = place(cursor);
+            const TextLine &line = paragraphs[at.paragraph].lines[at.line];
+            moveTo(ctrl ? buffer.size() : at.start + line.start + line.length, shift);
+            return true;
+        }
+        case SDLK_BACKSPACE:
+            if (selectionStart == selectionEnd)
+            {
+                selectionStart = ctrl ? wordBefore(cursor) : charBefore(cursor);
+            }
+            replace(selectionStart, selectionEnd, "");
+            return true;
+        case SDLK_DELETE:
+            if (selectionStart == selectionEnd)
+            {
+                selectionEnd = ctrl ? wordAfter(cursor) : charAfter(cursor);
+            }
+            replace(selectionStart, selectionEnd, "");
+            return true;
+        case SDLK_RETURN:
+        case SDLK_KP_ENTER:
+            type("\n");
+            return true;
+        default:
+            break;
+        }
+        if (!ctrl)
+        {
+            return false;
+        }
+        if (key == SDLK_a)
+        {
+            anchor = 0;
+            cursor = buffer.size();
+            goalX = -1;
+            return true;
+        }
+        if (key == SDLK_c || key == SDLK_x)
+        {
+            if (selectionStart < selectionEnd)
+            {
+                buffer.copy(selectionStart, selectionEnd - selectionStart, scratch);
+                SDL_SetClipboardText(scratch.c_str());
+                if (key == SDLK_x)
+                {
+                    replace(selectionStart, selectionEnd, "");
+                }
+            }
+            return true;
+        }
+        if (key == SDLK_v)
+        {
+            char *pasted = SDL_GetClipboardText();
+            if (pasted != NULL)
+            {
+                type(pasted);
+                SDL_free(pasted);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Method to put text in place of the selection
+    void type(const string &text)
+    {
+        replace(min(cursor, anchor), max(cursor, anchor), text);
+    }
+
+    // Method to replace the bytes [from, to) with text, lay out the paragraphs it touched and put the cursor after it
+    void replace(size_t from, size_t to, const string &text)
+    {
+        Place first = place(from), last = place(to);
+        if (from != to || !text.empty())
+        {
+            edits++;
+        }
+        buffer.erase(from, to - from);
+        buffer.insert(from, text.data(), text.size());
+        if (first.paragraph == last.paragraph && text.find('\n') == string::npos)
+        {
+            Paragraph &paragraph = paragraphs[first.paragraph];
+            paragraph.length = paragraph.length - (to - from) + text.size();
+            relayout(first.paragraph, first.start, from - first.start, to - from, text.size());
+        }
+        else
+        {
+            // Newlines were added or removed, so the paragraphs from first to last are split up again
+            size_t end = last.start + paragraphs[last.paragraph].length - (to - from) + text.size();
+            paragraphs.erase(paragraphs.begin() + first.paragraph, paragraphs.begin() + last.paragraph + 1);
+            int p = first.paragraph;
+            size_t start = first.start;
+            while (true)
+            {
+                size_t length = 0;
+                while (start + length < end && buffer[start + length] != '\n')
+                {
+                    length++;
+                }
+                paragraphs.insert(paragraphs.begin() + p, Paragraph());
+                paragraphs[p].length = length;
+                layoutParagraph(p, start);
+                if (start + length >= end)
+                {
+                    break;
+                }
+                start += length + 1;
+                p++;
+            }
+        }
+        cursor = anchor = from + text.size();
+        goalX = -1;
+        keepCursorVisible();
+    }
+
+    // Method to wrap a whole paragraph that starts at byte start
+    void layoutParagraph(int p, size_t start)
+    {
+        Paragraph &paragraph = paragraphs[p];
+        buffer.copy(start, paragraph.length, scratch);
+        paragraph.lines.clear();
+        layout.breakLines(font, scratch, 0, scratch.size(), wrapWidth(), paragraph.lines);
+    }
+
+    // Method to wrap a paragraph again after removed bytes at offset at were replaced by inserted ones.
+    // Lines before the one above the edit cannot change; after the edit, once a line starts at the same text
+    // an old line started at, the rest of the old lines are the new ones shifted along.
+    void relayout(int p, size_t start, size_t at, size_t removed, size_t inserted)
+    {
+        Paragraph &paragraph = paragraphs[p];
+        vector<TextLine> old;
+        old.swap(paragraph.lines);
+        int first = 0;
+        while (first + 1 < (int)old.size() && old[first + 1].start <= at)
+        {
+            first++;
+        }
+        first = max(0, first - 1);
+        paragraph.lines.assign(old.begin(), old.begin() + first);
+        buffer.copy(start, paragraph.length, scratch);
+        size_t lineStart = old[first].start;
+        size_t next = 0;
+        int match = first + 1;
+        while (true)
+        {
+            paragraph.lines.push_back(layout.fitLine(font, scratch, lineStart, scratch.size(), wrapWidth(), next));
+            if (next >= scratch.size())
+            {
+                break;
+            }
+            if (next >= at + inserted)
+            {
+                size_t oldStart = next - inserted + removed;
+                while (match < (int)old.size() && old[match].start < oldStart)
+                {
+                    match++;
+                }
+                if (match < (int)old.size() && old[match].start == oldStart)
+                {
+                    for (; match < (int)old.size(); match++)
+                    {
+                        TextLine line = {old[match].start - removed + inserted, old[match].length};
+                        paragraph.lines.push_back(line);
+                    }
+                    break;
+                }
+            }
+            lineStart = next;
+        }
+    }
+
+    // Method to find the paragraph, line and row a byte position is on
+    Place place(size_t pos)
+    {
+        Place at = {0, 0, 0, 0};
+        while (at.paragraph + 1 < (int)paragraphs.size() && at.start + paragraphs[at.paragraph].length < pos)
+        {
+            at.row += paragraphs[at.paragraph].lines.size();
+            at.start += paragraphs[at.paragraph].length + 1;
+            at.paragraph++;
+        }
+        const vector<TextLine> &lines = paragraphs[at.paragraph].lines;
+        while (at.line + 1 < (int)lines.size() && at.start + lines[at.line + 1].start <= pos)
+        {
+            at.line++;
+        }
+        at.row += at.line;
+        return at;
+    }
+
+    // Method to find the paragraph and line shown on a row, clamped to the text
+    Place placeRow(int row)
+    {
+        Place at = {0, 0, 0, 0};
+        row = max(0, row);
+        while (at.paragraph + 1 < (int)paragraphs.size() && at.row + (int)paragraphs[at.paragraph].lines.size() <= row)
+        {
+            at.row += paragraphs[at.paragraph].lines.size();
+            at.start += paragraphs[at.paragraph].length + 1;
+            at.paragraph++;
+        }
+        at.line = min(row - at.row, (int)paragraphs[at.paragraph].lines.size() - 1);
+        at.row += at.line;
+        return at;
+    }
+
+    // Pixels from the start of a line at byte lineStart to byte pos on it
+    int measure(size_t lineStart, size_t pos)
+    {
+        string part;
+        buffer.copy(lineStart, pos - lineStart, part);
+        return glyphs.width(font, part);
+    }
+
+    // The byte position on a line nearest to x pixels from its start
+    size_t positionAt(const Place &at, int x)
+    {
+        const TextLine &line = paragraphs[at.paragraph].lines[at.line];
+        string text;
+        buffer.copy(at.start + line.start, line.length, text);
+        int pen = 0;
+        Uint32 previous = 0;
+        for (size_t i = 0; i < text.size();)
+        {
+            size_t before = i;
+            Uint32 point = utf8Next(text, i);
+            int step = glyphs.kerning(font, previous, point) + glyphs.advance(font, point);
+            if (pen + step / 2 >= x)
+            {
+                return at.start + line.start + before;
+            }
+            pen += step;
+            previous = point;
+        }
+        return at.start + line.start + line.length;
+    }
+
+    void moveTo(size_t pos, bool extend)
+    {
+        cursor = pos;
+        if (!extend)
+        {
+            anchor = pos;
+        }
+        goalX = -1;
+        keepCursorVisible();
+    }
+
+    // Method to move the cursor up or down some rows, keeping to the column it started from
+    void moveRows(int count, bool extend)
+    {
+        Place at = place(cursor);
+        int x = goalX >= 0 ? goalX : measure(at.start + paragraphs[at.paragraph].lines[at.line].start, cursor);
+        moveTo(positionAt(placeRow(at.row + count), x), extend);
+        goalX = x;
+    }
+
+    // Method to scroll just enough for the cursor's row to be in view
+    void keepCursorVisible()
+    {
+        int top = place(cursor).row * rowHeight();
+        if (top < scrollY)
+        {
+            scrollY = top;
+        }
+        else if (top + rowHeight() > scrollY + view.h)
+        {
+            scrollY = top + rowHeight() - view.h;
+        }
+        scrollY = max(0, min(scrollY, maxScroll()));
+    }
+
+    // Positions one code point before and after pos, stepping over UTF-8 continuation bytes
+    size_t charBefore(size_t pos) const
+    {
+        if (pos == 0)
+        {
+            return 0;
+        }
+        pos--;
+        while (pos > 0 && ((unsigned char)buffer[pos] & 0xC0) == 0x80)
+        {
+            pos--;
+        }
+        return pos;
+    }
+    size_t charAfter(size_t pos) const
+    {
+        if (pos >= buffer.size())
+        {
+            return buffer.size();
+        }
+        pos++;
+        while (pos < buffer.size() && ((unsigned char)buffer[pos] & 0xC0) == 0x80)
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    static bool isBlank(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t';
+    }
+
+    // Start of the word before pos and end of the word after it, skipping the blanks next to pos first
+    size_t wordBefore(size_t pos) const
+    {
+        while (pos > 0 && isBlank(buffer[pos - 1]))
+        {
+            pos--;
+        }
+        while (pos > 0 && !isBlank(buffer[pos - 1]))
+        {
+            pos--;
+        }
+        return pos;
+    }
+    size_t wordAfter(size_t pos) const
+    {
+        while (pos < buffer.size() && isBlank(buffer[pos]))
+        {
+            pos++;
+        }
+        while (pos < buffer.size() && !isBlank(buffer[pos]))
+        {
+            pos++;
+        }
+        return pos;
+    }
+};
+#endif
@@ -0,0 +1,198 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "textRenderer.hpp"
+using namespace std;
+
+const int TEXT_LAYOUT_CACHE = 4096; // paragraphs whose line breaks are kept before the cache is trimmed
+
+// One wrapped line: the bytes [start, start + length) of the laid-out text, without the spaces it was broken at
+struct TextLine
+{
+    size_t start;
+    size_t length;
+};
+
+// Wraps UTF-8 text into lines no wider than a pixel width, measured with the font's glyph advances and kerning.
+// Lines break after the last space that fits; a word wider than the whole line is broken between characters.
+// Each paragraph (run of text between newlines) is laid out on its own and its breaks are cached under a hash of its
+// bytes, the font and the width, so redrawing the same text costs one hash per paragraph, and after an edit only the
+// paragraph that changed is measured again.
+class TextLayout
+{
+public:
+    TextLayout(TextRenderer &renderer) : glyphs(renderer), uses(0), lastFont(NULL), lastWidth(-1) {}
+
+    // Method to lay out text at a pixel width; the lines stay valid until the next call
+    const vector<TextLine> &wrap(TTF_Font *font, const string &text, int width)
+    {
+        // Frames mostly draw what they drew last time
+        if (font == lastFont && width == lastWidth && text == lastText)
+        {
+            return lines;
+        }
+        lastFont = font;
+        lastWidth = width;
+        lastText = text;
+        lines.clear();
+        uses++;
+        size_t start = 0;
+        while (true)
+        {
+            size_t end = text.find('\n', start);
+            if (end == string::npos)
+            {
+                end = text.size();
+            }
+            const Paragraph &paragraph = layout(font, text, start, end, width);
+            for (const TextLine &line : paragraph.lines)
+            {
+                TextLine placed = {start + line.start, line.length};
+                lines.push_back(placed);
+            }
+            if (end == text.size())
+            {
+                break;
+            }
+            start = end + 1;
+        }
+        trim();
+        return lines;
+    }
+
+    // Method to fit one line of the paragraph text[start, end) that begins at start; next becomes the start of the
+    // line after it, which is end once the paragraph is used up. Only the text from start on is looked at, so a
+    // line starting at the same place in the same text always comes out the same.
+    TextLine fitLine(TTF_Font *font, const string &text, size_t start, size_t end, int width, size_t &next)
+    {
+        size_t spaceStart = string::npos; // first space of the last run of spaces on the line
+        size_t wordStart = string::npos;  // first byte after that run, where the next line would start
+        int pen = 0;                      // pixels from the line start to here
+        Uint32 previous = 0;
+        for (size_t i = start; i < end;)
+        {
+            size_t at = i;
+            Uint32 point = utf8Next(text, i);
+            if (point == ' ')
+            {
+                // Spaces may hang past the edge; the line breaks after them
+                if (previous != ' ')
+                {
+                    spaceStart = at;
+                }
+                pen += glyphs.kerning(font, previous, point) + glyphs.advance(font, point);
+                wordStart = i;
+                previous = point;
+                continue;
+            }
+            pen += glyphs.kerning(font, previous, point) + glyphs.advance(font, point);
+            if (pen > width && at > start)
+            {
+                if (wordStart != string::npos && spaceStart > start)
+                {
+                    // The word being written moves down to the next line
+                    next = wordStart;
+                    TextLine line = {start, spaceStart - start};
+                    return line;
+                }
+                // A word wider than the whole line is split here
+                next = at;
+                TextLine line = {start, at - start};
+                return line;
+            }
+            previous = point;
+        }
+        next = end;
+        TextLine line = {start, end - start};
+        return line;
+    }
+
+    // Method to split text[begin, end) into lines that fit the width, with offsets relative to begin
+    void breakLines(TTF_Font *font, const string &text, size_t begin, size_t end, int width, vector<TextLine> &out)
+    {
+        size_t start = begin;
+        do
+        {
+            size_t next;
+            TextLine line = fitLine(font, text, start, end, width, next);
+            line.start -= begin;
+            out.push_back(line);
+            start = next;
+        } while (start < end);
+    }
+
+    // Method to forget every cached paragraph, for when a font is closed
+    void clear()
+    {
+        paragraphs.clear();
+        lines.clear();
+        lastFont = NULL;
+        lastWidth = -1;
+        lastText.clear();
+    }
+
+private:
+    struct Paragraph
+    {
+        size_t length;          // bytes in the paragraph, checked on lookup as a guard against hash collisions
+        vector<TextLine> lines; // relative to the start of the paragraph
+        unsigned used;
+    };
+    TextRenderer &glyphs;
+    unordered_map<uint64_t, Paragraph> paragraphs;
+    unsigned uses;
+    vector<TextLine> lines;
+    TTF_Font *lastFont;
+    int lastWidth;
+    string lastText;
+
+    TextLayout(const TextLayout &);
+    TextLayout &operator=(const TextLayout &);
+
+    // Method to find the cached breaks of the paragraph text[begin, end), wrapping it if it is not cached
+    const Paragraph &layout(TTF_Font *font, const string &text, size_t begin, size_t end, int width)
+    {
+        // FNV-1a over the bytes, then the font and width folded in the same way
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = begin; i < end; i++)
+        {
+            hash = (hash ^ (unsigned char)text[i]) * 1099511628211ULL;
+        }
+        hash = (hash ^ (uint64_t)(uintptr_t)font) * 1099511628211ULL;
+        hash = (hash ^ (uint64_t)(unsigned)width) * 1099511628211ULL;
+        Paragraph &paragraph = paragraphs[hash];
+        if (paragraph.lines.empty() || paragraph.length != end - begin)
+        {
+            paragraph.length = end - begin;
+            paragraph.lines.clear();
+            breakLines(font, text, begin, end, width, paragraph.lines);
+        }
+        paragraph.used = uses;
+        return paragraph;
+    }
+
+    // Method to drop every paragraph the last call did not use once the cache outgrows its limit
+    void trim()
+    {
+        if ((int)paragraphs.size() <= TEXT_LAYOUT_CACHE)
+        {
+            return;
+        }
+        for (unordered_map<uint64_t, Paragraph>::iterator it = paragraphs.begin(); it != paragraphs.end();)
+        {
+            if (it->second.used != uses)
+            {
+                it = paragraphs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+};
+#endif
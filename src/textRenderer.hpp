@@ -0,0 +1,332 @@
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+const int GLYPH_ATLAS_SIZE = 1024; // pixels per side of one atlas page
+const Uint32 REPLACEMENT_CHARACTER = 0xFFFD;
+
+// Function to read the UTF-8 code point starting at text[i] and move i past it; malformed bytes read as U+FFFD
+inline Uint32 utf8Next(const string &text, size_t &i)
+{
+    unsigned char lead = text[i++];
+    if (lead < 0x80)
+    {
+        return lead;
+    }
+    int extra = lead >= 0xF0 ? 3 : (lead >= 0xE0 ? 2 : (lead >= 0xC0 ? 1 : -1));
+    if (extra < 0 || lead > 0xF4)
+    {
+        return REPLACEMENT_CHARACTER;
+    }
+    Uint32 point = lead & (0x3F >> extra);
+    for (int k = 0; k < extra; k++)
+    {
+        if (i >= text.size() || ((unsigned char)text[i] & 0xC0) != 0x80)
+        {
+            return REPLACEMENT_CHARACTER;
+        }
+        point = (point << 6) | ((unsigned char)text[i++] & 0x3F);
+    }
+    return point;
+}
+
+// Draws strings from glyphs rasterized once per font into shared atlas textures.
+// The first time a character is drawn in a font it is rendered white with SDL_ttf and packed into an atlas page;
+// after that a string is a run of textured quads tinted by vertex color and sent in one SDL_RenderGeometry call
+// per atlas page, so drawing text creates no surfaces and no textures. Positions follow the font's advances and
+// kerning. Textures belong to the renderer they were drawn with; call clear() before that renderer is destroyed.
+class TextRenderer
+{
+public:
+    TextRenderer() {}
+    ~TextRenderer()
+    {
+        clear();
+    }
+
+    // Method to draw UTF-8 text with its top-left corner at (x, y)
+    void draw(SDL_Renderer *renderer, TTF_Font *font, const string &text, int x, int y, SDL_Color color)
+    {
+        draw(renderer, font, text, 0, text.size(), x, y, color);
+    }
+
+    // Method to draw the bytes [begin, end) of a string, such as one laid-out line, without copying them out
+    void draw(SDL_Renderer *renderer, TTF_Font *font, const string &text, size_t begin, size_t end, int x, int y, SDL_Color color)
+    {
+        if (font == NULL || begin >= end)
+        {
+            return;
+        }
+        FontAtlas &atlas = atlasFor(font);
+        for (vector<SDL_Vertex> &batch : batches)
+        {
+            batch.clear();
+        }
+        int pen = x;
+        Uint32 previous = 0;
+        for (size_t i = begin; i < end;)
+        {
+            Uint32 point = utf8Next(text, i);
+            Glyph &glyph = glyphFor(atlas, font, point);
+            if (previous != 0)
+            {
+                pen += TTF_GetFontKerningSizeGlyphs32(font, previous, glyph.point);
+            }
+            previous = glyph.point;
+            if (glyph.page < 0 && glyph.rect.w > 0)
+            {
+                rasterize(renderer, atlas, font, glyph);
+            }
+            if (glyph.page >= 0)
+            {
+                addQuad(glyph, pen, y, color);
+            }
+            pen += glyph.advance;
+        }
+        for (size_t page = 0; page < batches.size() && page < atlas.pages.size(); page++)
+        {
+            if (batches[page].empty())
+            {
+                continue;
+            }
+            indices.clear();
+            for (int quad = 0; quad < (int)batches[page].size() / 4; quad++)
+            {
+                int corner[6] = {0, 1, 2, 2, 1, 3};
+                for (int k = 0; k < 6; k++)
+                {
+                    indices.push_back(quad * 4 + corner[k]);
+                }
+            }
+            SDL_RenderGeometry(renderer, atlas.pages[page].texture, batches[page].data(), batches[page].size(), indices.data(), indices.size());
+        }
+    }
+
+    // Width in pixels the text takes when drawn; needs no renderer, only the font's metrics
+    int width(TTF_Font *font, const string &text)
+    {
+        if (font == NULL)
+        {
+            return 0;
+        }
+        FontAtlas &atlas = atlasFor(font);
+        int pen = 0;
+        Uint32 previous = 0;
+        for (size_t i = 0; i < text.size();)
+        {
+            Glyph &glyph = glyphFor(atlas, font, utf8Next(text, i));
+            if (previous != 0)
+            {
+                pen += TTF_GetFontKerningSizeGlyphs32(font, previous, glyph.point);
+            }
+            previous = glyph.point;
+            pen += glyph.advance;
+        }
+        return pen;
+    }
+
+    // Advance of one code point, and the kerning to add between two, for callers that measure text as they go
+    int advance(TTF_Font *font, Uint32 point)
+    {
+        return font != NULL ? glyphFor(atlasFor(font), font, point).advance : 0;
+    }
+    int kerning(TTF_Font *font, Uint32 previous, Uint32 point)
+    {
+        return font != NULL && previous != 0 ? TTF_GetFontKerningSizeGlyphs32(font, previous, point) : 0;
+    }
+
+    int lineHeight(TTF_Font *font)
+    {
+        return font != NULL ? atlasFor(font).height : 0;
+    }
+
+    // Method to drop the atlas of a font that is about to be closed
+    void forget(TTF_Font *font)
+    {
+        unordered_map<TTF_Font *, FontAtlas *>::iterator it = fonts.find(font);
+        if (it != fonts.end())
+        {
+            release(it->second);
+            fonts.erase(it);
+        }
+    }
+
+    // Method to free every atlas
+    void clear()
+    {
+        for (pair<TTF_Font *const, FontAtlas *> &font : fonts)
+        {
+            release(font.second);
+        }
+        fonts.clear();
+    }
+
+private:
+    struct Glyph
+    {
+        Uint32 point; // code point actually drawn; missing characters fall back to '?'
+        int advance;
+        int page;     // atlas page holding the pixels, -1 until first drawn
+        SDL_Rect rect; // where the pixels are on that page; the size is known before they are rendered
+        Glyph() : point(0), advance(0), page(-1), rect({0, 0, 0, 0}) {}
+    };
+    struct Page
+    {
+        SDL_Texture *texture;
+        int shelfX, shelfY, shelfHeight; // glyphs are packed left to right on shelves stacked top to bottom
+    };
+    struct FontAtlas
+    {
+        int height;
+        Glyph ascii[128];
+        bool asciiLoaded[128];
+        unordered_map<Uint32, Glyph> others;
+        vector<Page> pages;
+    };
+    unordered_map<TTF_Font *, FontAtlas *> fonts;
+    vector<vector<SDL_Vertex>> batches; // quads of the string being drawn, per atlas page
+    vector<int> indices;
+
+    TextRenderer(const TextRenderer &);
+    TextRenderer &operator=(const TextRenderer &);
+
+    FontAtlas &atlasFor(TTF_Font *font)
+    {
+        FontAtlas *&atlas = fonts[font];
+        if (atlas == NULL)
+        {
+            atlas = new FontAtlas();
+            atlas->height = TTF_FontHeight(font);
+            for (int c = 0; c < 128; c++)
+            {
+                atlas->asciiLoaded[c] = false;
+            }
+        }
+        return *atlas;
+    }
+
+    // Method to look up a glyph's metrics, measuring it the first time
+    Glyph &glyphFor(FontAtlas &atlas, TTF_Font *font, Uint32 point)
+    {
+        Glyph *glyph;
+        if (point < 128)
+        {
+            glyph = &atlas.ascii[point];
+            if (atlas.asciiLoaded[point])
+            {
+                return *glyph;
+            }
+            atlas.asciiLoaded[point] = true;
+        }
+        else
+        {
+            unordered_map<Uint32, Glyph>::iterator it = atlas.others.find(point);
+            if (it != atlas.others.end())
+            {
+                return it->second;
+            }
+            glyph = &atlas.others[point];
+        }
+        glyph->point = TTF_GlyphIsProvided32(font, point) ? point : '?';
+        int minX, maxX, minY, maxY, advance;
+        if (TTF_GlyphMetrics32(font, glyph->point, &minX, &maxX, &minY, &maxY, &advance) == 0)
+        {
+            glyph->advance = advance;
+            // SDL_ttf renders a glyph as wide as its advance or its ink, whichever is wider, and a full line high
+            glyph->rect.w = point == ' ' ? 0 : max(advance, maxX);
+            glyph->rect.h = atlas.height;
+        }
+        return *glyph;
+    }
+
+    // Method to render a glyph and copy it into the first atlas page with room for it
+    void rasterize(SDL_Renderer *renderer, FontAtlas &atlas, TTF_Font *font, Glyph &glyph)
+    {
+        SDL_Color white = {255, 255, 255, 255};
+        SDL_Surface *rendered = TTF_RenderGlyph32_Blended(font, glyph.point, white);
+        SDL_Surface *surface = rendered != NULL ? SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0) : NULL;
+        SDL_FreeSurface(rendered);
+        if (surface == NULL || surface->w + 1 > GLYPH_ATLAS_SIZE || surface->h + 1 > GLYPH_ATLAS_SIZE)
+        {
+            cerr << "Unable to render glyph " << glyph.point << "! SDL_ttf Error: " << TTF_GetError() << endl;
+            SDL_FreeSurface(surface);
+            glyph.rect.w = 0; // draw nothing for it from now on
+            return;
+        }
+        glyph.rect.w = surface->w;
+        glyph.rect.h = surface->h;
+        // A pixel of space around each glyph keeps filtering from bleeding its neighbours in
+        Page *page = atlas.pages.empty() ? NULL : &atlas.pages.back();
+        if (page != NULL && page->shelfX + surface->w + 1 > GLYPH_ATLAS_SIZE)
+        {
+            page->shelfY += page->shelfHeight + 1;
+            page->shelfX = 0;
+            page->shelfHeight = 0;
+        }
+        if (page == NULL || page->shelfY + surface->h + 1 > GLYPH_ATLAS_SIZE)
+        {
+            page = addPage(renderer, atlas);
+            if (page == NULL)
+            {
+                SDL_FreeSurface(surface);
+                glyph.rect.w = 0;
+                return;
+            }
+        }
+        glyph.rect.x = page->shelfX;
+        glyph.rect.y = page->shelfY;
+        SDL_UpdateTexture(page->texture, &glyph.rect, surface->pixels, surface->pitch);
+        glyph.page = atlas.pages.size() - 1;
+        page->shelfX += surface->w + 1;
+        page->shelfHeight = max(page->shelfHeight, surface->h);
+        SDL_FreeSurface(surface);
+    }
+
+    Page *addPage(SDL_Renderer *renderer, FontAtlas &atlas)
+    {
+        SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE);
+        if (texture == NULL)
+        {
+            cerr << "Failed to create glyph atlas: " << SDL_GetError() << endl;
+            return NULL;
+        }
+        vector<Uint8> clear(GLYPH_ATLAS_SIZE * GLYPH_ATLAS_SIZE * 4, 0);
+        SDL_UpdateTexture(texture, NULL, clear.data(), GLYPH_ATLAS_SIZE * 4);
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        Page page = {texture, 0, 0, 0};
+        atlas.pages.push_back(page);
+        return &atlas.pages.back();
+    }
+
+    void addQuad(const Glyph &glyph, int x, int y, SDL_Color color)
+    {
+        if (glyph.page >= (int)batches.size())
+        {
+            batches.resize(glyph.page + 1);
+        }
+        float left = glyph.rect.x / (float)GLYPH_ATLAS_SIZE, top = glyph.rect.y / (float)GLYPH_ATLAS_SIZE;
+        float right = (glyph.rect.x + glyph.rect.w) / (float)GLYPH_ATLAS_SIZE, bottom = (glyph.rect.y + glyph.rect.h) / (float)GLYPH_ATLAS_SIZE;
+        vector<SDL_Vertex> &batch = batches[glyph.page];
+        batch.push_back({{(float)x, (float)y}, color, {left, top}});
+        batch.push_back({{(float)(x + glyph.rect.w), (float)y}, color, {right, top}});
+        batch.push_back({{(float)x, (float)(y + glyph.rect.h)}, color, {left, bottom}});
+        batch.push_back({{(float)(x + glyph.rect.w), (float)(y + glyph.rect.h)}, color, {right, bottom}});
+    }
+
+    void release(FontAtlas *atlas)
+    {
+        for (Page &page : atlas->pages)
+        {
+            SDL_DestroyTexture(page.texture);
+        }
+        delete atlas;
+    }
+};
+#endif
@@ -0,0 +1,230 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+// Above are preprocessor directives that guard against multiple inclusion of the same header file.
+#include <SDL.h>
+#include <deque>
+#include <functional>
+#include <vector>
+using namespace std;
+
+// A fixed set of SDL worker threads with one job deque each.
+// A worker runs the newest job from its own deque and, when that is empty, steals the oldest job from another
+// worker, so jobs that fan out into smaller jobs keep every core busy without a single shared queue.
+class ThreadPool
+{
+public:
+    // workers <= 0 starts one worker per CPU core
+    ThreadPool(int workers = 0) : queued(0), pending(0), stopping(false), nextWorker(0)
+    {
+        if (workers <= 0)
+        {
+            workers = SDL_GetCPUCount();
+        }
+        lock = SDL_CreateMutex();
+        jobReady = SDL_CreateCond();
+        allDone = SDL_CreateCond();
+        for (int i = 0; i < workers; i++)
+        {
+            lanes.push_back(new Lane());
+        }
+        for (int i = 0; i < workers; i++)
+        {
+            threads.push_back(SDL_CreateThread(workerMain, "worker", new Start{this, i}));
+            lanes[i]->owner = SDL_GetThreadID(threads.back());
+        }
+    }
+    ~ThreadPool()
+    {
+        SDL_LockMutex(lock);
+        stopping = true;
+        SDL_CondBroadcast(jobReady);
+        SDL_UnlockMutex(lock);
+        for (SDL_Thread *thread : threads)
+        {
+            SDL_WaitThread(thread, NULL);
+        }
+        for (Lane *lane : lanes)
+        {
+            SDL_DestroyMutex(lane->lock);
+            delete lane;
+        }
+        SDL_DestroyCond(jobReady);
+        SDL_DestroyCond(allDone);
+        SDL_DestroyMutex(lock);
+    }
+
+    // Method to queue a job. Jobs submitted from a worker go on that worker's own deque, others are spread round-robin.
+    void submit(function<void()> job)
+    {
+        int worker = currentWorker();
+        SDL_LockMutex(lock);
+        if (worker < 0)
+        {
+            worker = nextWorker;
+            nextWorker = (nextWorker + 1) % lanes.size();
+        }
+        pending++;
+        SDL_UnlockMutex(lock);
+        Lane *lane = lanes[worker];
+        SDL_LockMutex(lane->lock);
+        lane->jobs.push_back(job);
+        SDL_UnlockMutex(lane->lock);
+        // The job may already have been taken, leaving queued at -1 for a moment; waiting workers treat that as empty
+        SDL_LockMutex(lock);
+        queued++;
+        SDL_CondSignal(jobReady);
+        SDL_UnlockMutex(lock);
+    }
+
+    // Method to run one queued job on the calling thread; false when there was nothing to run.
+    // A thread waiting on jobs it submitted calls this so it helps instead of blocking a worker.
+    bool runOne()
+    {
+        function<void()> job;
+        if (!take(currentWorker(), job))
+        {
+            return false;
+        }
+        finish(job);
+        return true;
+    }
+
+    // Method to block until every submitted job has finished
+    void wait()
+    {
+        SDL_LockMutex(lock);
+        while (pending > 0)
+        {
+            SDL_CondWait(allDone, lock);
+        }
+        SDL_UnlockMutex(lock);
+    }
+
+    // True when no submitted job is queued or running
+    bool idle()
+    {
+        SDL_LockMutex(lock);
+        bool result = pending == 0;
+        SDL_UnlockMutex(lock);
+        return result;
+    }
+
+    int size() const
+    {
+        return threads.size();
+    }
+
+private:
+    struct Lane
+    {
+        SDL_mutex *lock;
+        deque<function<void()>> jobs;
+        SDL_threadID owner;
+        Lane() : lock(SDL_CreateMutex()), owner(0) {}
+    };
+    struct Start
+    {
+        ThreadPool *pool;
+        int index;
+    };
+    vector<SDL_Thread *> threads;
+    vector<Lane *> lanes;
+    int queued;  // jobs sitting in some deque
+    int pending; // jobs queued or running
+    bool stopping;
+    int nextWorker;
+    SDL_mutex *lock;
+    SDL_cond *jobReady;
+    SDL_cond *allDone;
+
+    static int workerMain(void *data)
+    {
+        Start start = *(Start *)data;
+        delete (Start *)data;
+        start.pool->work(start.index);
+        return 0;
+    }
+
+    // Index of the worker running on this thread, or -1 for threads outside the pool
+    int currentWorker() const
+    {
+        SDL_threadID self = SDL_ThreadID();
+        for (int i = 0; i < (int)lanes.size(); i++)
+        {
+            if (lanes[i]->owner == self)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Method to take the newest job of our own deque, or else steal the oldest job of another one
+    bool take(int worker, function<void()> &job)
+    {
+        int count = lanes.size();
+        for (int i = 0; i < count; i++)
+        {
+            int victim = worker < 0 ? i : (worker + i) % count;
+            Lane *lane = lanes[victim];
+            SDL_LockMutex(lane->lock);
+            bool found = !lane->jobs.empty();
+            if (found && victim == worker)
+            {
+                job = lane->jobs.back();
+                lane->jobs.pop_back();
+            }
+            else if (found)
+            {
+                job = lane->jobs.front();
+                lane->jobs.pop_front();
+            }
+            SDL_UnlockMutex(lane->lock);
+            if (found)
+            {
+                SDL_LockMutex(lock);
+                queued--;
+                SDL_UnlockMutex(lock);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void finish(function<void()> &job)
+    {
+        job();
+        SDL_LockMutex(lock);
+        pending--;
+        if (pending == 0)
+        {
+            SDL_CondBroadcast(allDone);
+        }
+        SDL_UnlockMutex(lock);
+    }
+
+    void work(int worker)
+    {
+        while (true)
+        {
+            function<void()> job;
+            if (take(worker, job))
+            {
+                finish(job);
+                continue;
+            }
+            SDL_LockMutex(lock);
+            while (queued <= 0 && !stopping)
+            {
+                SDL_CondWait(jobReady, lock);
+            }
+            bool done = stopping && queued <= 0;
+            SDL_UnlockMutex(lock);
+            if (done)
+            {
+                return;
+            }
+        }
+    }
+};
+#endif
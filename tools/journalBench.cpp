@@ -0,0 +1,477 @@
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <random>
+#include <sstream>
+#include "DSA.hpp"
+#include "journalStore.hpp"
+#include "journalTags.hpp"
+#include "journalTransfer.hpp"
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+using namespace std;
+// Journal benchmark: times adding, looking up, range-walking and deleting entries by entry number in the
+// old DoublyLinkedList, a plain vector and JournalIndex, then the time to open and read a journal on disk, then
+// the throughput of exporting and importing it as JSON Lines and as a Markdown folder, then tag filters.
+// usage: JournalBench [--sizes 100000,1000000] [--ops n] [--list-max n] [--open n] [--transfer n] [--tags n] [--seed n]
+
+// Sums of what the timed loops read, stored so the compiler cannot drop the loops
+volatile long long benchSink;
+
+// Method to time a call in milliseconds
+template <typename F>
+double measure(F run)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+    run();
+    return (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+// Timings of one container at one size; every operation is in nanoseconds per call
+struct BenchRow
+{
+    string container;
+    int size;
+    double append, get, range, erase;
+};
+
+void printRow(const BenchRow &row)
+{
+    printf("%-10s %9d %12.1f %12.1f %12.1f %12.1f\n", row.container.c_str(), row.size, row.append, row.get, row.range, row.erase);
+}
+
+JournalEntry makeEntry(uint32_t id)
+{
+    JournalEntry entry = {(uint64_t)id * 64, (int64_t)id, id, 40};
+    return entry;
+}
+
+// The old journal: every lookup and delete walks the list from its head
+BenchRow benchList(int n, int ops, mt19937 &random)
+{
+    BenchRow row = {"list", n, 0, 0, 0, 0};
+    DoublyLinkedList list;
+    row.append = measure([&]()
+    {
+        for (int i = 0; i < n; i++)
+        {
+            list.addNode("entry");
+        }
+    }) * 1e6 / n;
+    long long sink = 0;
+    row.get = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            sink += list.getNodeByIndex(random() % n + 1)->length;
+        }
+    }) * 1e6 / ops;
+    row.range = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            node *current = list.getNodeByIndex(random() % n + 1);
+            for (int k = 0; k < 10 && current != NULL; k++, current = current->next)
+            {
+                sink += current->length;
+            }
+        }
+    }) * 1e6 / ops;
+    row.erase = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            list.deleteNode(random() % (n - i) + 1);
+        }
+    }) * 1e6 / ops;
+    benchSink = sink;
+    return row;
+}
+
+// A flat array: O(1) lookups, but every delete shifts all the entries behind it
+BenchRow benchVector(int n, int ops, mt19937 &random)
+{
+    BenchRow row = {"vector", n, 0, 0, 0, 0};
+    vector<JournalEntry> entries;
+    row.append = measure([&]()
+    {
+        for (int i = 0; i < n; i++)
+        {
+            entries.push_back(makeEntry(i + 1));
+        }
+    }) * 1e6 / n;
+    long long sink = 0;
+    row.get = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            sink += entries[random() % n].id;
+        }
+    }) * 1e6 / ops;
+    row.range = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            int first = random() % n;
+            for (int k = first; k < first + 10 && k < n; k++)
+            {
+                sink += entries[k].id;
+            }
+        }
+    }) * 1e6 / ops;
+    row.erase = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            entries.erase(entries.begin() + random() % (n - i));
+        }
+    }) * 1e6 / ops;
+    benchSink = sink;
+    return row;
+}
+
+BenchRow benchIndex(int n, int ops, mt19937 &random)
+{
+    BenchRow row = {"index", n, 0, 0, 0, 0};
+    JournalIndex entries;
+    row.append = measure([&]()
+    {
+        for (int i = 0; i < n; i++)
+        {
+            entries.push_back(makeEntry(i + 1));
+        }
+    }) * 1e6 / n;
+    long long sink = 0;
+    row.get = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            sink += entries[random() % n].id;
+        }
+    }) * 1e6 / ops;
+    row.range = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            entries.forRange(random() % n, 10, [&sink](const JournalEntry &entry)
+            {
+                sink += entry.id;
+            });
+        }
+    }) * 1e6 / ops;
+    row.erase = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            entries.erase(random() % (n - i));
+        }
+    }) * 1e6 / ops;
+    benchSink = sink;
+    return row;
+}
+
+// Method to write a journal of n entries, then time opening it and reading bodies from it
+void benchStore(int n, int ops, mt19937 &random)
+{
+    const string logFile = "journalBench.log", indexFile = "journalBench.idx";
+    remove(logFile.c_str());
+    remove(indexFile.c_str());
+    double write, open, read;
+    {
+        JournalStore journal;
+        if (!journal.open(logFile, indexFile))
+        {
+            return;
+        }
+        write = measure([&]()
+        {
+            for (int i = 0; i < n; i++)
+            {
+                journal.append("Entry " + to_string(i) + ": today was a good day and I wrote about it.");
+            }
+            journal.close();
+        });
+    }
+    JournalStore journal;
+    open = measure([&]()
+    {
+        journal.open(logFile, indexFile);
+    });
+    string body;
+    read = measure([&]()
+    {
+        for (int i = 0; i < ops; i++)
+        {
+            journal.read(random() % journal.size(), body);
+        }
+    });
+    printf("journal of %d entries: write and close %.1f ms, open %.2f ms, read %.2f us per entry\n", journal.size(), write, open, read * 1000 / ops);
+    journal.close();
+    remove(logFile.c_str());
+    remove(indexFile.c_str());
+}
+
+// Peak resident memory of the process in KB, or 0 where it cannot be read
+long peakMemory()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#endif
+}
+
+// Method to delete a folder and everything in it
+void removeFolder(const string &path)
+{
+    vector<string> folders, files;
+    if (!journalListFolder(path, folders, files))
+    {
+        return;
+    }
+    for (const string &name : files)
+    {
+        remove((path + "/" + name).c_str());
+    }
+    for (const string &name : folders)
+    {
+        removeFolder(path + "/" + name);
+    }
+#ifdef _WIN32
+    _rmdir(path.c_str());
+#else
+    rmdir(path.c_str());
+#endif
+}
+
+void printTransfer(const char *name, double ms, const JournalTransfer &transfer)
+{
+    printf("%-16s %8d entries %9.1f ms %10.0f entries/s %8.1f MB/s   peak memory %ld KB\n", name, transfer.entries(), ms, transfer.entries() * 1000.0 / ms, transfer.transferred() / 1048576.0 * 1000.0 / ms, peakMemory());
+}
+
+// Method to write a journal of n entries, then time exporting it to each format and importing that into an empty journal
+void benchTransfer(int n, mt19937 &random)
+{
+    const string logFile = "journalBench.log", indexFile = "journalBench.idx", copyLog = "journalCopy.log", copyIndex = "journalCopy.idx";
+    const string lines = "journalBench.jsonl", folder = "journalBench.md";
+    const char *words[] = {"today", "walked", "\"quiet\"", "coffee", "rain", "tired", "grateful", "work", "friends", "slept"};
+    {
+        JournalStore journal;
+        remove(logFile.c_str());
+        remove(indexFile.c_str());
+        if (!journal.open(logFile, indexFile))
+        {
+            return;
+        }
+        // Entries a few minutes to a day apart and a few sentences long, some over several lines
+        int64_t written = 1600000000;
+        string body;
+        for (int i = 0; i < n; i++)
+        {
+            body.clear();
+            for (int k = 40 + random() % 80; k > 0; k--)
+            {
+                body += words[random() % 10];
+                body += random() % 12 == 0 ? "\n" : " ";
+            }
+            written += 300 + random() % 86400;
+            journal.append(body, written);
+        }
+        journal.close();
+    }
+    JournalStore journal;
+    journal.open(logFile, indexFile);
+    JournalTransfer transfer(journal);
+    printTransfer("export jsonl", measure([&]() { transfer.exportJsonLines(lines); }), transfer);
+    removeFolder(folder);
+    printTransfer("export markdown", measure([&]() { transfer.exportMarkdown(folder); }), transfer);
+    journal.close();
+    for (int format = 0; format < 2; format++)
+    {
+        remove(copyLog.c_str());
+        remove(copyIndex.c_str());
+        JournalStore copy;
+        copy.open(copyLog, copyIndex);
+        JournalTransfer into(copy);
+        double ms = measure([&]()
+        {
+            format == 0 ? into.importJsonLines(lines) : into.importMarkdown(folder);
+        });
+        printTransfer(format == 0 ? "import jsonl" : "import markdown", ms, into);
+        copy.close();
+    }
+    remove(lines.c_str());
+    removeFolder(folder);
+    remove(logFile.c_str());
+    remove(indexFile.c_str());
+    remove(copyLog.c_str());
+    remove(copyIndex.c_str());
+}
+
+// Method to tag n entries the way a journal might, then time tag filters against a scan of every entry's tags
+void benchTags(int n, int ops, mt19937 &random)
+{
+    const char *names[] = {"#work", "#sleep", "#family", "#exercise", "#friends", "#health", "#travel", "#reading"};
+    const int chance[] = {2, 3, 5, 6, 8, 12, 40, 50}; // one entry in this many carries the tag
+    JournalTags tags;
+    vector<uint32_t> masks(n + 1);
+    double build = measure([&]()
+    {
+        string text;
+        for (int id = 1; id <= n; id++)
+        {
+            text = "Entry";
+            for (int t = 0; t < 8; t++)
+            {
+                if (random() % chance[t] == 0)
+                {
+                    text = text + " " + names[t];
+                    masks[id] |= 1 << t;
+                }
+            }
+            tags.add(id, text);
+        }
+    });
+    printf("tag index of %d entries: built in %.1f ms\n", n, build);
+    // Each filter beside the same test made on every entry's tags in turn, which is what it costs without an index
+    struct TagFilter
+    {
+        const char *query;
+        bool (*matches)(uint32_t tags);
+    };
+    const TagFilter filters[] = {
+        {"#work AND NOT #sleep", [](uint32_t m) { return (m & 1) && !(m & 2); }},
+        {"#family OR #friends", [](uint32_t m) { return (m & 4) || (m & 16); }},
+        {"#exercise #health NOT #travel", [](uint32_t m) { return (m & 8) && (m & 32) && !(m & 64); }},
+        {"NOT #work", [](uint32_t m) { return !(m & 1); }},
+    };
+    RoaringBitmap result;
+    vector<uint32_t> ids;
+    long long sink = 0;
+    for (const TagFilter &filter : filters)
+    {
+        double ms = measure([&]()
+        {
+            for (int i = 0; i < ops; i++)
+            {
+                tags.filter(filter.query, result);
+                sink += result.size();
+            }
+        });
+        // Listing the matches is a separate cost, paid only for the entries a screen shows
+        double list = measure([&]()
+        {
+            for (int i = 0; i < ops; i++)
+            {
+                result.largest(10, ids);
+            }
+        });
+        int scanned = 0;
+        double scan = measure([&]()
+        {
+            for (int id = 1; id <= n; id++)
+            {
+                scanned += filter.matches(masks[id]);
+            }
+        });
+        sink += scanned;
+        printf("%-30s %7u entries %8.1f us per filter, %.2f us for the newest 10 (scanning every entry: %.1f us)\n", filter.query, result.size(), ms * 1000 / ops, list * 1000 / ops, scan * 1000);
+    }
+    benchSink = sink;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<int> sizes = {100000, 1000000};
+    int ops = 10000;
+    int listMax = 100000;
+    int openEntries = 100000;
+    int transferEntries = 100000;
+    int tagEntries = 100000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            cerr << "missing value for " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--sizes")
+        {
+            sizes.clear();
+            stringstream list(value);
+            string item;
+            while (getline(list, item, ','))
+            {
+                sizes.push_back(atoi(item.c_str()));
+            }
+        }
+        else if (arg == "--ops")
+        {
+            ops = atoi(value.c_str());
+        }
+        else if (arg == "--list-max")
+        {
+            listMax = atoi(value.c_str());
+        }
+        else if (arg == "--open")
+        {
+            openEntries = atoi(value.c_str());
+        }
+        else if (arg == "--transfer")
+        {
+            transferEntries = atoi(value.c_str());
+        }
+        else if (arg == "--tags")
+        {
+            tagEntries = atoi(value.c_str());
+        }
+        else if (arg == "--seed")
+        {
+            seed = atoi(value.c_str());
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--sizes 100000,1000000] [--ops n] [--list-max n] [--open n] [--transfer n] [--tags n] [--seed n]" << endl;
+            return 1;
+        }
+    }
+
+    mt19937 random(seed);
+    printf("%-10s %9s %12s %12s %12s %12s\n", "container", "entries", "append ns", "get ns", "range10 ns", "erase ns");
+    for (int n : sizes)
+    {
+        // Each operation count stays below n so the deletes never empty the container
+        int count = min(ops, n / 2);
+        if (count <= 0)
+        {
+            continue;
+        }
+        // The list walks half its length per call, so it only runs at sizes where that finishes in seconds
+        if (n <= listMax)
+        {
+            printRow(benchList(n, min(count, 1000), random));
+        }
+        printRow(benchVector(n, count, random));
+        printRow(benchIndex(n, count, random));
+    }
+    if (openEntries > 0)
+    {
+        benchStore(openEntries, min(ops, openEntries), random);
+    }
+    if (transferEntries > 0)
+    {
+        benchTransfer(transferEntries, random);
+    }
+    if (tagEntries > 0)
+    {
+        benchTags(tagEntries, min(ops, 1000), random);
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <string>
+#include "journalStore.hpp"
+#include "journalTransfer.hpp"
+using namespace std;
+// Journal import and export: copies a journal's entries out to JSON Lines or a Markdown folder, or appends the
+// entries found in them to a journal. The search index catches up with imported entries the next time it is opened.
+// usage: JournalTransfer export|import jsonl|markdown <file or folder> [--journal <log> <index>]
+int main(int argc, char *argv[])
+{
+    string logFile = "textFiles/journal.log", indexFile = "textFiles/journal.idx";
+    if (argc == 7 && string(argv[4]) == "--journal")
+    {
+        logFile = argv[5];
+        indexFile = argv[6];
+    }
+    string direction = argc > 1 ? argv[1] : "", format = argc > 2 ? argv[2] : "";
+    if ((argc != 4 && argc != 7) || (direction != "export" && direction != "import") || (format != "jsonl" && format != "markdown"))
+    {
+        cerr << "usage: " << argv[0] << " export|import jsonl|markdown <file or folder> [--journal <log> <index>]" << endl;
+        return 1;
+    }
+
+    JournalStore journal;
+    if (!journal.open(logFile, indexFile))
+    {
+        return 1;
+    }
+    JournalTransfer transfer(journal);
+    string path = argv[3];
+    Uint64 start = SDL_GetPerformanceCounter();
+    bool ok;
+    if (direction == "export")
+    {
+        ok = format == "jsonl" ? transfer.exportJsonLines(path) : transfer.exportMarkdown(path);
+    }
+    else
+    {
+        ok = format == "jsonl" ? transfer.importJsonLines(path) : transfer.importMarkdown(path);
+    }
+    double seconds = (SDL_GetPerformanceCounter() - start) / (double)SDL_GetPerformanceFrequency();
+    journal.close();
+    cout << (direction == "export" ? "exported " : "imported ") << transfer.entries() << " entries (" << transfer.transferred() / 1024 << " KB) in " << seconds << " s";
+    if (transfer.rejected() > 0)
+    {
+        cout << ", skipped " << transfer.rejected();
+    }
+    cout << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+#include "threadPool.hpp"
+#include "flowGenerator.hpp"
+#include "levelPack.hpp"
+#include <cstdlib>
+using namespace std;
+// Batch level generator: fills a level pack with uniquely solvable FlowFree levels using every CPU core
+// usage: LevelGen <rows> <cols> <colors> <count> <output pack> [workers] [square|torus]
+// Outputs ending in .pack are written as binary level packs, anything else as a text pack.
+int main(int argc, char *argv[])
+{
+    if (argc < 6)
+    {
+        cerr << "usage: " << argv[0] << " <rows> <cols> <colors> <count> <output pack> [workers] [square|torus]" << endl;
+        return 1;
+    }
+    int rows = atoi(argv[1]);
+    int cols = atoi(argv[2]);
+    int colors = atoi(argv[3]);
+    int count = atoi(argv[4]);
+    string output = argv[5];
+    int workers = argc > 6 ? atoi(argv[6]) : 0;
+    FlowTopology::Kind topology = FlowTopology::SQUARE;
+    if (argc > 7 && !FlowTopology::parse(argv[7], topology))
+    {
+        cerr << "Unknown topology: " << argv[7] << endl;
+        return 1;
+    }
+    if (rows <= 0 || cols <= 0 || colors <= 0 || count <= 0)
+    {
+        cerr << "rows, cols, colors and count must be positive" << endl;
+        return 1;
+    }
+
+    SDL_Init(0);
+    vector<FlowPuzzle> levels;
+    SDL_mutex *levelsLock = SDL_CreateMutex();
+    int failures = 0;
+    Uint32 start = SDL_GetTicks();
+    {
+        ThreadPool pool(workers);
+        cout << "Generating " << count << " " << rows << "x" << cols << " levels with " << colors << " colors on " << pool.size() << " workers" << endl;
+        unsigned seed = random_device()();
+        for (int i = 0; i < count; i++)
+        {
+            pool.submit([&, i]()
+            {
+                FlowGenerator generator(seed + i);
+                generator.setTopology(topology);
+                FlowPuzzle level;
+                bool ok = generator.generate(rows, cols, colors, level);
+                SDL_LockMutex(levelsLock);
+                if (ok)
+                {
+                    levels.push_back(level);
+                }
+                else
+                {
+                    failures++;
+                }
+                SDL_UnlockMutex(levelsLock);
+            });
+        }
+        pool.wait();
+    }
+    Uint32 elapsed = SDL_GetTicks() - start;
+    SDL_DestroyMutex(levelsLock);
+
+    bool binary = output.size() > 5 && output.compare(output.size() - 5, 5, ".pack") == 0;
+    if (!(binary ? writeLevelPack(output, levels) : saveLevelPack(output, levels)))
+    {
+        return 1;
+    }
+    cout << "Wrote " << levels.size() << " levels to " << output << " in " << elapsed << " ms";
+    if (elapsed > 0)
+    {
+        cout << " (" << levels.size() * 60000.0 / elapsed << " levels/minute)";
+    }
+    cout << endl;
+    if (failures > 0)
+    {
+        cout << failures << " generation jobs gave up; try more colors for this board size" << endl;
+    }
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "flowLevel.hpp"
+#include "levelPack.hpp"
+using namespace std;
+// Level pack converter: builds a binary level pack from level text files and text level packs.
+// Each plain level file is solved once here, so the game never has to solve or parse at a level switch.
+// usage: LevelPack <output pack> <level file or text pack>...
+//        LevelPack --list <pack>
+int main(int argc, char *argv[])
+{
+    if (argc == 3 && string(argv[1]) == "--list")
+    {
+        LevelPack pack;
+        if (!pack.open(argv[2]))
+        {
+            return 1;
+        }
+        cout << argv[2] << ": " << pack.size() << " levels" << endl;
+        for (int i = 0; i < pack.size(); i++)
+        {
+            PackedLevel level;
+            pack.level(i, level);
+            cout << "  " << i + 1 << ": " << level.rows << "x" << level.cols << ", " << level.colors << " colors, difficulty " << level.difficulty << (level.topology == FlowTopology::HEX ? ", hex" : (level.topology == FlowTopology::TORUS ? ", torus" : ""))
+                 << (level.solution != NULL ? "" : ", no solution") << endl;
+        }
+        return 0;
+    }
+    if (argc < 3)
+    {
+        cerr << "usage: " << argv[0] << " <output pack> <level file or text pack>..." << endl;
+        cerr << "       " << argv[0] << " --list <pack>" << endl;
+        return 1;
+    }
+
+    vector<FlowPuzzle> levels;
+    for (int arg = 2; arg < argc; arg++)
+    {
+        string input = argv[arg];
+        ifstream probe(input);
+        string tag;
+        probe >> tag;
+        probe.close();
+        if (tag == "level")
+        {
+            if (!loadLevelPack(input, levels))
+            {
+                return 1;
+            }
+            continue;
+        }
+        // A single hand-made level: read it and store its solution alongside it
+        FlowLevel model;
+        if (!model.loadFromFile(input, 0xFFFF))
+        {
+            return 1;
+        }
+        int n = model.getSize();
+        if (model.getNodes() != n * n)
+        {
+            cerr << "Level packs cannot hold bridges: " << input << endl;
+            return 1;
+        }
+        FlowSolver solver;
+        if (!solver.load(model.getTopology(), model.getCells()))
+        {
+            cerr << "Invalid level: " << input << endl;
+            return 1;
+        }
+        int solutions = solver.solve(2);
+        if (solutions == 0)
+        {
+            cerr << "Level has no solution: " << input << endl;
+            return 1;
+        }
+        if (solutions > 1)
+        {
+            cerr << "Warning: " << input << " has more than one solution; storing the first" << endl;
+        }
+        FlowPuzzle level;
+        level.rows = n;
+        level.cols = n;
+        level.colors = model.getColors();
+        level.topology = model.getTopology().getKind();
+        level.cells = model.getCells();
+        level.solution = solver.solution();
+        level.difficulty = FlowGenerator::rateDifficulty(solver.getStats(), n * n);
+        levels.push_back(level);
+    }
+
+    if (!writeLevelPack(argv[1], levels))
+    {
+        return 1;
+    }
+    cout << "Wrote " << levels.size() << " levels to " << argv[1] << endl;
+    return 0;
+}
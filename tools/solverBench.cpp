@@ -0,0 +1,312 @@
+#include <cstdlib>
+#include <cstdio>
+#include <sstream>
+#include "flowGrid.hpp"
+#include "flowLevel.hpp"
+#include "levelPack.hpp"
+#include "parallelSolver.hpp"
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+using namespace std;
+// Solver benchmark: runs every solver implementation over the shipped levels and a corpus of generated
+// puzzles of growing size, and reports wall time, nodes, backtracks, recursion depth and peak heap use.
+// usage: SolverBench [--sizes 6,8,10] [--count n] [--seed n] [--limit nodes] [--threads n] [--csv file] [--json file]
+
+// Heap bytes in use and the high-water mark since the last reset, kept by the allocation operators below.
+// They are atomic because the parallel engine allocates from several threads.
+static atomic<size_t> heapInUse(0);
+static atomic<size_t> heapPeak(0);
+static const size_t HEAP_HEADER = 16; // keeps the returned block 16 byte aligned
+
+void *operator new(size_t size)
+{
+    char *block = (char *)malloc(size + HEAP_HEADER);
+    if (block == NULL)
+    {
+        throw bad_alloc();
+    }
+    *(size_t *)block = size;
+    size_t inUse = heapInUse += size;
+    size_t peak = heapPeak;
+    while (inUse > peak && !heapPeak.compare_exchange_weak(peak, inUse))
+    {
+    }
+    return block + HEAP_HEADER;
+}
+void operator delete(void *pointer) noexcept
+{
+    if (pointer != NULL)
+    {
+        char *block = (char *)pointer - HEAP_HEADER;
+        heapInUse -= *(size_t *)block;
+        free(block);
+    }
+}
+void operator delete(void *pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+// A benchmark puzzle: starting cells of a square board
+struct BenchLevel
+{
+    string name;
+    int size, colors;
+    vector<int> cells;
+};
+
+// One solver run on one puzzle
+struct BenchResult
+{
+    string solver, level;
+    int size, colors;
+    string outcome; // solved, unsolved or limit
+    bool full;      // the solution covers every cell
+    double ms;
+    SolverStats stats;
+    size_t peakHeap;
+};
+
+// Method to time a solver call in milliseconds and measure the heap it allocated on top of what was already in use
+template <typename F>
+void measure(BenchResult &result, F run)
+{
+    size_t base = heapInUse;
+    heapPeak = base;
+    Uint64 start = SDL_GetPerformanceCounter();
+    run();
+    result.ms = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+    result.peakHeap = heapPeak - base;
+}
+
+BenchResult runGrid(const BenchLevel &level, long long limit)
+{
+    BenchResult result;
+    Grid grid;
+    grid.loadFromCells(level.size, level.cells);
+    pair<int, int> p = grid.get_color();
+    int color = grid.getValue(p.first, p.second);
+    bool solved = false;
+    measure(result, [&]()
+    {
+        solved = grid.solve(p.first, p.second, color, limit);
+    });
+    result.outcome = solved ? "solved" : (grid.exhausted() ? "limit" : "unsolved");
+    result.full = solved;
+    for (int row = 0; row < level.size && solved; row++)
+    {
+        for (int col = 0; col < level.size; col++)
+        {
+            result.full = result.full && grid.getValue(row, col) != 0;
+        }
+    }
+    result.stats = grid.getStats();
+    return result;
+}
+
+// maxCount 2 is the uniqueness proof the generator runs on every candidate
+BenchResult runFlowSolver(const BenchLevel &level, long long limit, int maxCount)
+{
+    BenchResult result;
+    FlowSolver solver;
+    solver.load(level.size, level.size, level.cells);
+    int found = 0;
+    measure(result, [&]()
+    {
+        found = solver.solve(maxCount, limit);
+    });
+    result.outcome = solver.exhausted() ? "limit" : (found > 0 ? "solved" : "unsolved");
+    result.full = found > 0;
+    result.stats = solver.getStats();
+    return result;
+}
+
+// The same uniqueness proof split across a thread pool
+BenchResult runParallel(const BenchLevel &level, long long limit, ThreadPool &pool)
+{
+    BenchResult result;
+    ParallelSolver solver(pool);
+    solver.load(level.size, level.size, level.cells);
+    int found = 0;
+    measure(result, [&]()
+    {
+        found = solver.solve(2, limit);
+    });
+    result.outcome = solver.exhausted() ? "limit" : (found > 0 ? "solved" : "unsolved");
+    result.full = found > 0;
+    result.stats = solver.getStats();
+    return result;
+}
+
+// Method to collect the shipped levels, from the binary pack when present and the text files otherwise.
+// Only square boards are benchmarked, since the original Grid solver knows no other shape.
+void shippedLevels(vector<BenchLevel> &levels)
+{
+    LevelPack pack;
+    if (pack.open("textFiles/levels.pack"))
+    {
+        for (int i = 0; i < pack.size(); i++)
+        {
+            FlowPuzzle puzzle;
+            pack.level(i, puzzle);
+            if (puzzle.rows == puzzle.cols && puzzle.topology == FlowTopology::SQUARE)
+            {
+                levels.push_back({"shipped" + to_string(i + 1), puzzle.rows, puzzle.colors, puzzle.cells});
+            }
+        }
+        return;
+    }
+    for (int i = 1;; i++)
+    {
+        string filename = "textFiles/level" + to_string(i) + ".txt";
+        if (!ifstream(filename).is_open())
+        {
+            break;
+        }
+        FlowLevel model;
+        if (model.loadFromFile(filename, 0xFFFF) && model.getTopology().getKind() == FlowTopology::SQUARE && model.getNodes() == model.getSize() * model.getSize())
+        {
+            levels.push_back({"shipped" + to_string(i), model.getSize(), model.getColors(), model.getCells()});
+        }
+    }
+}
+
+string jsonEscape(const string &text)
+{
+    string out;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+int main(int argc, char *argv[])
+{
+    vector<int> sizes = {6, 8, 10, 12, 14};
+    int count = 3;
+    unsigned seed = 1;
+    long long limit = 5000000;
+    int threads = 0;
+    string csvFile, jsonFile;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            cerr << "missing value for " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--sizes")
+        {
+            sizes.clear();
+            stringstream list(value);
+            string item;
+            while (getline(list, item, ','))
+            {
+                sizes.push_back(atoi(item.c_str()));
+            }
+        }
+        else if (arg == "--count")
+        {
+            count = atoi(value.c_str());
+        }
+        else if (arg == "--seed")
+        {
+            seed = atoi(value.c_str());
+        }
+        else if (arg == "--limit")
+        {
+            limit = atoll(value.c_str());
+        }
+        else if (arg == "--threads")
+        {
+            threads = atoi(value.c_str());
+        }
+        else if (arg == "--csv")
+        {
+            csvFile = value;
+        }
+        else if (arg == "--json")
+        {
+            jsonFile = value;
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--sizes 6,8,10] [--count n] [--seed n] [--limit nodes] [--threads n] [--csv file] [--json file]" << endl;
+            return 1;
+        }
+    }
+
+    // The corpus is reproducible for a given seed, so runs on different builds compare like with like
+    vector<BenchLevel> levels;
+    shippedLevels(levels);
+    FlowGenerator generator(seed);
+    for (int size : sizes)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            FlowPuzzle puzzle;
+            if (size >= 3 && generator.generate(size, size, max(1, size * size / 6), puzzle))
+            {
+                levels.push_back({"gen" + to_string(size) + "-" + to_string(i + 1), size, puzzle.colors, puzzle.cells});
+            }
+        }
+    }
+
+    ThreadPool pool(threads);
+    const char *engines[] = {"grid", "flow", "unique", "parallel"};
+    vector<BenchResult> results;
+    printf("%-8s %-12s %5s %6s %-9s %5s %10s %12s %12s %6s %11s\n", "solver", "level", "size", "colors", "outcome", "full", "ms", "nodes", "backtracks", "depth", "peak heap");
+    for (const BenchLevel &level : levels)
+    {
+        for (int engine = 0; engine < 4; engine++)
+        {
+            BenchResult result = engine == 0 ? runGrid(level, limit) : (engine == 3 ? runParallel(level, limit, pool) : runFlowSolver(level, limit, engine));
+            result.solver = engines[engine];
+            result.level = level.name;
+            result.size = level.size;
+            result.colors = level.colors;
+            printf("%-8s %-12s %5d %6d %-9s %5s %10.3f %12lld %12lld %6d %11zu\n", result.solver.c_str(), result.level.c_str(), result.size, result.colors,
+                   result.outcome.c_str(), result.full ? "yes" : "no", result.ms, result.stats.nodes, result.stats.backtracks, result.stats.maxDepth, result.peakHeap);
+            results.push_back(result);
+        }
+    }
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("process peak resident set: %ld KB\n", usage.ru_maxrss);
+#endif
+
+    if (!csvFile.empty())
+    {
+        ofstream csv(csvFile);
+        csv << "solver,level,size,colors,outcome,full,ms,nodes,backtracks,max_depth,peak_heap_bytes\n";
+        for (const BenchResult &r : results)
+        {
+            csv << r.solver << "," << r.level << "," << r.size << "," << r.colors << "," << r.outcome << "," << r.full << "," << r.ms << ","
+                << r.stats.nodes << "," << r.stats.backtracks << "," << r.stats.maxDepth << "," << r.peakHeap << "\n";
+        }
+    }
+    if (!jsonFile.empty())
+    {
+        ofstream json(jsonFile);
+        json << "[\n";
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const BenchResult &r = results[i];
+            json << "  {\"solver\": \"" << jsonEscape(r.solver) << "\", \"level\": \"" << jsonEscape(r.level) << "\", \"size\": " << r.size
+                 << ", \"colors\": " << r.colors << ", \"outcome\": \"" << r.outcome << "\", \"full\": " << (r.full ? "true" : "false")
+                 << ", \"ms\": " << r.ms << ", \"nodes\": " << r.stats.nodes << ", \"backtracks\": " << r.stats.backtracks
+                 << ", \"max_depth\": " << r.stats.maxDepth << ", \"peak_heap_bytes\": " << r.peakHeap << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        json << "]\n";
+    }
+    return 0;
+}